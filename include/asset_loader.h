@@ -17,6 +17,40 @@ struct AssetLoadResult {
     std::shared_ptr<struct TextureBundle> textureBundle;
 };
 
+class TextureCache;
+class TextureMipChain;
+
+struct AssetLoadOptions {
+    // Decode every texture while loading. When false, only the dictionary and
+    // texture headers are parsed and pixels are decoded on first request.
+    bool decodeTextures = true;
+
+    // Ask the OS to read the whole file in the background as soon as it is
+    // opened, for loads that are not waited on.
+    bool readAhead = false;
+
+    // Persistent cache consulted before decoding a level and filled after.
+    std::shared_ptr<TextureCache> textureCache;
+};
+
+// Read-only RGBA8 pixels of one texture level. Points into memory owned by the
+// TextureImage it came from, which must outlive the view.
+class PixelView {
+public:
+    PixelView() = default;
+    PixelView(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const uint8_t* begin() const { return m_data; }
+    const uint8_t* end() const { return m_data + m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
+
 struct TextureImage {
     uint32_t hash = 0;
     uint16_t width = 0;
@@ -24,17 +58,57 @@ struct TextureImage {
     uint32_t format = 0;
     uint32_t numLevels = 0;
     uint32_t paletteEntries = 0;
-    std::vector<uint8_t> rgba;
+
+    // Copy of every level's raw GX data, decoded on first request. Null only
+    // for images that were not produced by a loader.
+    std::shared_ptr<TextureMipChain> mipChain;
+
+    // Number of levels available through levelPixels(), including level 0.
+    uint32_t levelCount() const;
+    uint16_t levelWidth(uint32_t level) const;
+    uint16_t levelHeight(uint32_t level) const;
+
+    // RGBA8 pixels of a mip level, decoded (or read from the texture cache)
+    // the first time they are asked for unless the bundle was loaded with
+    // decodeTextures. An empty view means the level is unavailable.
+    PixelView levelPixels(uint32_t level) const;
+    PixelView pixels() const { return levelPixels(0); }
+
+    // True once a level's pixels are available without decoding.
+    bool isLevelDecoded(uint32_t level) const;
+
+    // Heap memory held by the image's copy of its GX data and by decoded
+    // levels; levels mapped from the texture cache are not counted.
+    size_t heapBytes() const;
+
+    // Longest side of the thumbnail; smaller images keep their own size. A
+    // power of two, so power-of-two textures filter in whole blocks.
+    static constexpr uint16_t kThumbnailSize = 128;
+    uint16_t thumbnailWidth() const;
+    uint16_t thumbnailHeight() const;
+
+    // Box-filtered RGBA8 copy of the image at thumbnail size, built from the
+    // smallest level that covers it the first time it is asked for.
+    PixelView thumbnailPixels() const;
+};
+
+// Order of the 2-bit CMPR color indices within a block, probed once per bundle.
+enum class CMPRBitOrder : uint8_t {
+    Unknown,
+    MsbFirst,
+    LsbFirst
 };
 
 struct TextureBundle {
     std::vector<TextureImage> textures;
+    CMPRBitOrder cmprBitOrder = CMPRBitOrder::Unknown;
 };
 
 class IAssetLoader {
 public:
     virtual ~IAssetLoader() = default;
-    virtual AssetLoadResult load(const std::filesystem::path& path) const = 0;
+    virtual AssetLoadResult load(const std::filesystem::path& path, const AssetLoadOptions& options) const = 0;
+    AssetLoadResult load(const std::filesystem::path& path) const { return load(path, AssetLoadOptions{}); }
     virtual const char* name() const = 0;
     virtual const char* extension() const = 0;
 };
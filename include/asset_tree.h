@@ -1,8 +1,12 @@
 #ifndef SMSTRIKERS_ASSET_TREE_H
 #define SMSTRIKERS_ASSET_TREE_H
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace SMStrikers {
@@ -14,11 +18,38 @@ enum class AssetKind {
     ModelBundle
 };
 
+using AssetNodeIndex = uint32_t;
+constexpr AssetNodeIndex kInvalidAssetNode = UINT32_MAX;
+
+/**
+ * @brief One entry of the flattened asset tree
+ *
+ * The strings point into the model's string storage and stay valid until the
+ * next loadFromFilesystem(). Both are NUL-terminated, so data() can be passed
+ * to C APIs. The name is the tail of the path.
+ */
 struct AssetNode {
-    std::string name;
+    std::string_view name;
+    std::string_view relativePath;
     AssetKind kind = AssetKind::File;
-    std::string relativePath;
-    std::vector<AssetNode> children;
+    AssetNodeIndex parent = kInvalidAssetNode;
+    // Children occupy [firstChild, firstChild + childCount), sorted
+    AssetNodeIndex firstChild = 0;
+    uint32_t childCount = 0;
+};
+
+/**
+ * @brief A directory as the last scan saw it, including ones without loadable files
+ */
+struct ScannedDirectory {
+    // Stands for a modification time too recent to trust
+    static constexpr int64_t kUnknownModified = INT64_MIN;
+
+    std::string relativePath; // "" for the root
+    // Read before the directory was listed, in file clock ticks
+    int64_t modified = kUnknownModified;
+    // Names of the loadable files and folders it held
+    std::vector<std::string> entries;
 };
 
 struct AssetTreeStats {
@@ -28,24 +59,99 @@ struct AssetTreeStats {
     size_t loadableCount = 0;
 };
 
+/**
+ * @brief Assets under a root directory, stored as a flat node array
+ *
+ * Index 0 is an unnamed node standing for the root directory itself; the
+ * top-level entries are its children. Lookups by path and by name go through
+ * hash indices.
+ *
+ * addFile() and remove() edit the tree in place. They may move nodes to
+ * other indices, so callers holding indices should look them up again by
+ * path afterwards.
+ */
 class AssetTreeModel {
 public:
-    bool loadFromFilesystem(const std::string& rootPath);
-    const std::vector<AssetNode>& roots() const { return m_roots; }
+    /**
+     * @brief Scan the root directory and rebuild the tree
+     *
+     * With an index path, the full directory tree is saved there together
+     * with each directory's modification time. The next load takes every
+     * directory whose time still matches from the index instead of listing
+     * it, so only changed directories are read.
+     * @param indexPath Index file, or empty to always list everything
+     * @param reuseIndex false to list everything and rewrite the index
+     * @param directories If given, receives every directory of the tree, parents first
+     */
+    bool loadFromFilesystem(const std::string& rootPath, const std::filesystem::path& indexPath = {},
+                            bool reuseIndex = true, std::vector<ScannedDirectory>* directories = nullptr);
     const std::string& rootPath() const { return m_rootPathString; }
     const AssetTreeStats& stats() const { return m_stats; }
-    const AssetNode* findByPath(const std::string& relativePath) const;
     bool hasRoot() const { return !m_rootPathString.empty(); }
 
+    /**
+     * @brief Changes whenever nodes are added, removed or moved
+     */
+    uint64_t revision() const { return m_revision; }
+
+    static constexpr AssetNodeIndex kRootIndex = 0;
+
+    /**
+     * @brief Node at index, or null for kInvalidAssetNode and out-of-range indices
+     */
+    const AssetNode* node(AssetNodeIndex index) const {
+        return index < m_nodes.size() ? &m_nodes[index] : nullptr;
+    }
+    const AssetNode* root() const { return node(kRootIndex); }
+    bool empty() const { return m_nodes.empty() || m_nodes[kRootIndex].childCount == 0; }
+    AssetNodeIndex indexOf(const AssetNode& node) const { return static_cast<AssetNodeIndex>(&node - m_nodes.data()); }
+
+    AssetNodeIndex findByPath(std::string_view relativePath) const;
+
+    /**
+     * @brief First node with this file or folder name, in depth-first tree order
+     */
+    AssetNodeIndex findByName(std::string_view name) const;
+
+    /**
+     * @brief Add a loadable file, creating the folders above it as needed
+     * @return false if the file is already present or not loadable
+     */
+    bool addFile(std::string_view relativePath);
+
+    /**
+     * @brief Remove a file or folder with everything below it
+     *
+     * Folders left without any loadable file are removed as well, matching
+     * what a full scan would produce.
+     * @return false if nothing is known at that path
+     */
+    bool remove(std::string_view relativePath);
+
 private:
+    std::string_view internPath(std::string_view parentPath, std::string_view name);
+    AssetNodeIndex insertChild(AssetNodeIndex parentIndex, std::string_view name, AssetKind kind);
+    void moveNode(AssetNodeIndex from, AssetNodeIndex to);
+    void releaseSubtree(AssetNodeIndex index);
+    void countNode(AssetKind kind, bool added);
+    void compact();
+    void rebuildNameIndex() const;
+
     std::filesystem::path m_rootPath;
     std::string m_rootPathString;
-    std::vector<AssetNode> m_roots;
+    std::vector<AssetNode> m_nodes;
+    std::unordered_map<std::string_view, AssetNodeIndex> m_pathIndex;
+    // Built on first use after the tree changes
+    mutable std::unordered_map<std::string_view, AssetNodeIndex> m_nameIndex;
+    mutable bool m_nameIndexDirty = true;
+    // Slots left behind by edits, reclaimed by compact()
+    size_t m_deadNodes = 0;
+    // Fixed-size blocks, so handed-out views never move
+    std::vector<std::unique_ptr<char[]>> m_stringBlocks;
+    size_t m_stringBlockUsed = 0;
+    size_t m_stringBlockSize = 0;
     AssetTreeStats m_stats;
-
-    AssetNode buildNode(const std::filesystem::directory_entry& entry);
-    void buildChildren(const std::filesystem::path& dirPath, std::vector<AssetNode>& outChildren);
-    void accumulateStats(const AssetNode& node);
+    uint64_t m_revision = 0;
 };
 
 bool isLoadable(AssetKind kind);
@@ -53,6 +159,11 @@ const char* assetKindLabel(AssetKind kind);
 const char* assetKindShortLabel(AssetKind kind);
 AssetKind assetKindFromExtension(const std::string& extension);
 
+/**
+ * @brief Kind of a file from its name, ignoring the case of the extension
+ */
+AssetKind assetKindFromFileName(std::string_view fileName);
+
 } // namespace SMStrikers
 
 #endif // SMSTRIKERS_ASSET_TREE_H
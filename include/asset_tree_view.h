@@ -2,16 +2,50 @@
 #define SMSTRIKERS_ASSET_TREE_VIEW_H
 
 #include "asset_tree.h"
+#include <cstdint>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace SMStrikers {
 
+/**
+ * @brief Draws an AssetTreeModel as a tree of selectable rows
+ *
+ * Labels and item IDs are built once per model revision, and the expanded
+ * part of the tree is kept as a flat list of rows that is only rebuilt when
+ * a folder opens or closes. Each frame draws just the rows in view, through
+ * ImGuiListClipper, without allocating.
+ */
 class AssetTreeView {
 public:
-    void renderTree(const std::vector<AssetNode>& roots, std::string& selectedPath);
+    void renderTree(const AssetTreeModel& model, AssetNodeIndex& selectedIndex);
 
 private:
-    void renderTreeNode(const AssetNode& node, std::string& selectedPath);
+    // Per model node, indexed like the model
+    struct NodeEntry {
+        uint32_t labelOffset = 0; // Into m_labels, NUL-terminated
+        uintptr_t id = 0;         // Derived from the path, so it survives rebuilds
+        bool expanded = false;
+    };
+
+    struct Row {
+        AssetNodeIndex index = kInvalidAssetNode;
+        uint32_t depth = 0;
+    };
+
+    void rebuildEntries(const AssetTreeModel& model);
+    void rebuildRows(const AssetTreeModel& model);
+    void appendRows(const AssetTreeModel& model, const AssetNode& parent, uint32_t depth);
+
+    const AssetTreeModel* m_model = nullptr;
+    uint64_t m_revision = 0;
+    std::vector<NodeEntry> m_entries;
+    std::string m_labels;
+    std::vector<Row> m_rows;
+    bool m_rowsDirty = true;
+    // Kept by path, so folders stay open across rescans and edits
+    std::unordered_set<std::string> m_expandedPaths;
 };
 
 } // namespace SMStrikers
@@ -0,0 +1,97 @@
+#ifndef SMSTRIKERS_ASSET_TREE_WATCHER_H
+#define SMSTRIKERS_ASSET_TREE_WATCHER_H
+
+#include "asset_tree.h"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SMStrikers {
+
+/**
+ * @brief One filesystem change below a watched asset root
+ */
+struct AssetTreeChange {
+    enum class Kind {
+        Added,    // A loadable file appeared, possibly replacing one with its name
+        Modified, // A loadable file was written to in place
+        Removed,  // A file or folder disappeared, with everything below it
+        Rescan    // Events were lost; only a full rescan is reliable
+    };
+
+    Kind kind = Kind::Rescan;
+    std::string relativePath; // '/'-separated, as in AssetNode
+};
+
+/**
+ * @brief Watches an asset root for created, rewritten, deleted and renamed files
+ *
+ * A background thread follows the directory tree with inotify and turns its
+ * events into AssetTreeChanges, listing newly created or moved-in directories
+ * itself. The owner collects them with takeChanges() and applies them to its
+ * AssetTreeModel. Renames arrive as a removal plus additions.
+ *
+ * Watches are set up from the directories the owner's scan found, so the tree
+ * is not listed a second time. Only a directory whose modification time has
+ * moved since the scan read it is listed again, and the difference is
+ * reported as changes.
+ *
+ * Only implemented on Linux; start() fails elsewhere.
+ */
+class AssetTreeWatcher {
+public:
+    AssetTreeWatcher() = default;
+    ~AssetTreeWatcher();
+
+    AssetTreeWatcher(const AssetTreeWatcher&) = delete;
+    AssetTreeWatcher& operator=(const AssetTreeWatcher&) = delete;
+
+    /**
+     * @brief Start watching, stopping any previous watch first
+     *
+     * The root is watched before this returns; the other directories are
+     * watched on the background thread, and changes made to them since the
+     * scan are reported once they are.
+     * @param directories What AssetTreeModel::loadFromFilesystem() scanned
+     * @return false if watching is unsupported on this system or the root
+     *         cannot be watched; the watcher is then stopped
+     */
+    bool start(const std::filesystem::path& rootPath, std::vector<ScannedDirectory> directories);
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /**
+     * @brief Move the changes gathered so far to the end of changes
+     */
+    void takeChanges(std::vector<AssetTreeChange>& changes);
+
+private:
+    void run(std::vector<ScannedDirectory> directories);
+    void publish(std::vector<AssetTreeChange>& changes);
+    void handleEvents(const char* buffer, size_t size, std::vector<AssetTreeChange>& changes);
+    int addWatch(const std::string& relativeDir);
+    void watchScanned(const std::vector<ScannedDirectory>& directories, std::vector<AssetTreeChange>& changes);
+    void relist(const ScannedDirectory& directory, std::vector<AssetTreeChange>& changes);
+    void watchTree(const std::string& relativeDir, std::vector<AssetTreeChange>* added);
+    void unwatchTree(const std::string& relativeDir);
+
+    std::filesystem::path m_rootPath;
+    int m_inotifyFd = -1;
+    int m_wakeFd = -1;
+    // Watch descriptor -> relative directory ("" for the root); worker only
+    // once started
+    std::unordered_map<int, std::string> m_watches;
+    std::thread m_thread;
+    std::atomic<bool> m_stopRequested{false};
+
+    std::mutex m_mutex;
+    std::vector<AssetTreeChange> m_changes;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_ASSET_TREE_WATCHER_H
@@ -0,0 +1,145 @@
+#ifndef SMSTRIKERS_BACKGROUND_LOADER_H
+#define SMSTRIKERS_BACKGROUND_LOADER_H
+
+#include "asset_loader.h"
+#include "spsc_queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SMStrikers {
+
+/**
+ * @brief Loads one asset at a time on a worker thread
+ *
+ * A job runs the loader, then decodes level 0 and the thumbnail of every
+ * texture in the resulting bundle, spread over the shared thread pool.
+ * Progress is reported to the owning (render) thread as events through a
+ * lock-free queue, in completion order, so finished textures can be uploaded
+ * and shown while the rest are still decoding.
+ *
+ * Starting a job cancels the previous one; textures not yet started are
+ * skipped and its remaining events are tagged with a stale generation.
+ *
+ * Prefetch requests share the worker at lower priority: they only run while
+ * no job is waiting, and step aside at the next texture boundary when one
+ * arrives, resuming where they left off once it is done.
+ */
+class BackgroundLoader {
+public:
+    struct Event {
+        enum class Kind : uint8_t {
+            Loaded,
+            TextureDecoded,
+            Finished,
+            Prefetched
+        };
+
+        Kind kind = Kind::Finished;
+        uint64_t generation = 0;
+        size_t textureIndex = 0;                 // TextureDecoded: texture; Prefetched: request
+        std::shared_ptr<AssetLoadResult> result; // Loaded and Prefetched only
+    };
+
+    struct PrefetchRequest {
+        const IAssetLoader* loader = nullptr;
+        std::filesystem::path path;
+        AssetLoadOptions options;
+        // Decode all textures if their level 0 fits; otherwise only read the
+        // file ahead and parse its dictionary.
+        size_t decodeBudgetBytes = 0;
+    };
+
+    BackgroundLoader();
+    ~BackgroundLoader();
+
+    BackgroundLoader(const BackgroundLoader&) = delete;
+    BackgroundLoader& operator=(const BackgroundLoader&) = delete;
+
+    /**
+     * @brief Load an asset, then decode its textures
+     * @return Generation that tags this job's events
+     */
+    uint64_t load(const IAssetLoader* loader, const std::filesystem::path& path, const AssetLoadOptions& options);
+
+    /**
+     * @brief Decode the textures of an already loaded bundle
+     * @return Generation that tags this job's events
+     */
+    uint64_t decode(std::shared_ptr<TextureBundle> bundle);
+
+    /**
+     * @brief Stop the current job at the next texture boundary
+     */
+    void cancel();
+
+    /**
+     * @brief Replace the pending prefetch requests
+     * @return Generation that tags the Prefetched events
+     */
+    uint64_t prefetch(std::vector<PrefetchRequest> requests);
+
+    /**
+     * @brief Drop all prefetch requests, including the one in progress
+     */
+    void cancelPrefetch();
+
+    /**
+     * @brief Take the next event; call from the thread that starts jobs
+     */
+    bool poll(Event& event) { return m_events.tryPop(event); }
+
+    /**
+     * @brief Textures decoded and total textures of the current job
+     */
+    size_t texturesDecoded() const { return m_texturesDecoded.load(std::memory_order_relaxed); }
+    size_t texturesTotal() const { return m_texturesTotal.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        uint64_t generation = 0;
+        const IAssetLoader* loader = nullptr;
+        std::filesystem::path path;
+        AssetLoadOptions options;
+        std::shared_ptr<TextureBundle> bundle;
+    };
+
+    struct PrefetchJob {
+        uint64_t generation = 0;
+        size_t index = 0;
+        PrefetchRequest request;
+        std::shared_ptr<AssetLoadResult> result;
+        bool decode = false;
+        size_t nextTexture = 0;
+    };
+
+    uint64_t start(Job job);
+    void workerLoop();
+    void run(Job& job);
+    bool runPrefetch(PrefetchJob& job);
+    bool post(Event event, const std::atomic<uint64_t>& generation);
+
+    std::atomic<uint64_t> m_generation{0};
+    std::atomic<uint64_t> m_prefetchGeneration{0};
+    std::atomic<bool> m_jobPending{false};
+    std::atomic<size_t> m_texturesDecoded{0};
+    std::atomic<size_t> m_texturesTotal{0};
+    SpscQueue<Event> m_events;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::unique_ptr<Job> m_pending;
+    std::deque<PrefetchJob> m_prefetchQueue;
+    bool m_stopping = false;
+    std::thread m_worker;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_BACKGROUND_LOADER_H
@@ -29,6 +29,24 @@ struct Config {
 
     // Asset settings
     std::string assetsRoot = "game_assets";
+    bool watchAssetsRoot = true; // Follow file changes under the root (Linux)
+
+    // Decoded texture cache settings
+    bool textureCacheEnabled = true;
+    std::string textureCacheDir; // empty = platform cache directory
+    int textureCacheSizeMB = 1024;
+
+    // Bundle cache settings: recently viewed bundles kept in memory, by
+    // decoded CPU and uploaded GPU bytes; the GPU budget includes thumbnail pages
+    int bundleCacheCpuMB = 256;
+    int bundleCacheGpuMB = 256;
+    // Warm the previous and next loadable assets after each selection
+    bool prefetchNeighbors = true;
+
+    // Upload settings: texture bytes uploaded to the GPU per frame; 0 = no limit
+    int textureUploadMBPerFrame = 8;
+    // Released GL textures kept for reuse, on top of bundleCacheGpuMB
+    int texturePoolMB = 64;
     
     /**
      * @brief Load config from file
@@ -44,6 +62,11 @@ struct Config {
      * @brief Get default config file path
      */
     static std::string getDefaultPath();
+
+    /**
+     * @brief Get the asset index path, next to the default config file
+     */
+    static std::string getAssetIndexPath();
 };
 
 } // namespace SMStrikers
@@ -0,0 +1,100 @@
+#ifndef SMSTRIKERS_LOG_H
+#define SMSTRIKERS_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// Messages below this level are compiled out entirely. Debug builds keep
+// everything, release builds keep Info and above; override with
+// -DSMSTRIKERS_LOG_COMPILE_LEVEL=<0..5>.
+#ifndef SMSTRIKERS_LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define SMSTRIKERS_LOG_COMPILE_LEVEL 2
+#else
+#define SMSTRIKERS_LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
+namespace SMStrikers {
+
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+/**
+ * @brief Process-wide leveled logger
+ *
+ * Messages below Warn go into a fixed-size lock-free ring buffer and reach
+ * stdout on the next flush(), so logging threads never wait on terminal I/O.
+ * When the ring is full new messages are dropped and counted. Warn and Error
+ * flush the ring and go straight to stderr.
+ */
+class Log {
+public:
+    static constexpr LogLevel kCompileLevel = static_cast<LogLevel>(SMSTRIKERS_LOG_COMPILE_LEVEL);
+
+    /**
+     * @brief Whether a message at this level would be recorded
+     *
+     * Constant-folds to false below the compile-time level; otherwise a
+     * single relaxed atomic load.
+     */
+    static bool enabled(LogLevel level) {
+        return level >= kCompileLevel && level >= s_level.load(std::memory_order_relaxed);
+    }
+
+    static void setLevel(LogLevel level) { s_level.store(level, std::memory_order_relaxed); }
+    static LogLevel level() { return s_level.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Parse "trace", "debug", "info", "warn", "error" or "off"
+     */
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+    /**
+     * @brief Record a message; use the SMSTRIKERS_LOG_* macros instead
+     */
+    static void write(LogLevel level, const std::string& message);
+
+    /**
+     * @brief Write queued messages out, oldest first
+     *
+     * Called once per frame by the viewer and on exit.
+     */
+    static void flush();
+
+    /**
+     * @brief Number of messages lost to a full ring buffer
+     */
+    static uint64_t droppedCount();
+
+private:
+    static inline std::atomic<LogLevel> s_level{LogLevel::Info};
+};
+
+} // namespace SMStrikers
+
+// The message expression is only evaluated when the level is enabled.
+#define SMSTRIKERS_LOG(level, message)                                  \
+    do {                                                                \
+        if (::SMStrikers::Log::enabled(level)) {                        \
+            std::ostringstream smstrikersLogStream_;                    \
+            smstrikersLogStream_ << message;                            \
+            ::SMStrikers::Log::write(level, smstrikersLogStream_.str()); \
+        }                                                               \
+    } while (0)
+
+#define SMSTRIKERS_LOG_TRACE(message) SMSTRIKERS_LOG(::SMStrikers::LogLevel::Trace, message)
+#define SMSTRIKERS_LOG_DEBUG(message) SMSTRIKERS_LOG(::SMStrikers::LogLevel::Debug, message)
+#define SMSTRIKERS_LOG_INFO(message) SMSTRIKERS_LOG(::SMStrikers::LogLevel::Info, message)
+#define SMSTRIKERS_LOG_WARN(message) SMSTRIKERS_LOG(::SMStrikers::LogLevel::Warn, message)
+#define SMSTRIKERS_LOG_ERROR(message) SMSTRIKERS_LOG(::SMStrikers::LogLevel::Error, message)
+
+#endif // SMSTRIKERS_LOG_H
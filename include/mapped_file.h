@@ -0,0 +1,63 @@
+#ifndef SMSTRIKERS_MAPPED_FILE_H
+#define SMSTRIKERS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SMStrikers {
+
+/**
+ * @brief Read-only view of a whole file's bytes
+ *
+ * The file is memory-mapped where the platform supports it, so parsing and
+ * decoding read straight from the page cache. When mapping is not possible
+ * the file is read into a heap buffer instead. Holders of the shared pointer
+ * keep the mapping alive, but not the bytes: a mapped file truncated on disk
+ * faults on access past its new end. Keep it only while loading, and copy out
+ * whatever is needed afterwards.
+ */
+class MappedFile {
+public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Open a file for reading
+     * @param path File to open
+     * @param error Receives a short message when opening fails
+     * @return The file's bytes, or null on failure
+     */
+    static std::shared_ptr<const MappedFile> open(const std::filesystem::path& path, std::string& error);
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool isMapped() const { return m_mapped; }
+    uint8_t operator[](size_t offset) const { return m_data[offset]; }
+
+    /**
+     * @brief Ask the OS to start reading the whole file in the background
+     *
+     * Returns immediately; later accesses then hit the page cache. Does
+     * nothing for buffered files, which are already in memory.
+     */
+    void willNeed() const;
+
+private:
+    MappedFile() = default;
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<uint8_t> m_buffer;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_MAPPED_FILE_H
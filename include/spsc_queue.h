@@ -0,0 +1,76 @@
+#ifndef SMSTRIKERS_SPSC_QUEUE_H
+#define SMSTRIKERS_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace SMStrikers {
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer and one consumer thread
+ *
+ * tryPush() and tryPop() never block; they fail when the queue is full or
+ * empty respectively.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @param capacity Maximum number of queued items, rounded up to a power of two
+     */
+    explicit SpscQueue(size_t capacity)
+        : m_mask(roundUpToPowerOfTwo(capacity) - 1)
+        , m_slots(std::make_unique<T[]>(m_mask + 1))
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Producer side; leaves item untouched and returns false when full
+     */
+    bool tryPush(T& item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask) {
+            return false;
+        }
+        m_slots[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side; returns false when empty
+     */
+    bool tryPop(T& item) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(m_slots[head & m_mask]);
+        m_slots[head & m_mask] = T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_SPSC_QUEUE_H
@@ -0,0 +1,131 @@
+#ifndef SMSTRIKERS_TEXTURE_CACHE_H
+#define SMSTRIKERS_TEXTURE_CACHE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace SMStrikers {
+
+class MappedFile;
+
+/**
+ * @brief Persistent cache of decoded texture levels
+ *
+ * Each entry is one file named after a 64-bit key. The file holds a small
+ * header followed by the level's RGBA8 pixels, so a hit is served straight
+ * from a memory mapping of the file. Entries are evicted least recently used
+ * first once the directory grows past its byte budget.
+ *
+ * New entries are written by a background thread, so storing never waits on
+ * the disk. Access times are tracked in memory and written to the files'
+ * modification times when the cache is destroyed, so recency survives
+ * restarts without a syscall per lookup.
+ *
+ * Safe to use from several threads at once.
+ */
+class TextureCache {
+public:
+    /**
+     * @brief Offset of the pixel data within a mapped entry
+     */
+    static constexpr size_t kHeaderSize = 16;
+
+    /**
+     * @brief Open (and create if needed) a cache directory
+     * @param directory Where entries are stored
+     * @param maxBytes Budget for all entries together
+     */
+    TextureCache(std::filesystem::path directory, uint64_t maxBytes);
+
+    /**
+     * @brief Finish queued stores and record access times
+     */
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * @brief Default location: $XDG_CACHE_HOME or ~/.cache, under smstrikers-viewer/textures
+     */
+    static std::filesystem::path defaultDirectory();
+
+    /**
+     * @brief Key for a level from everything its decoded pixels depend on
+     * @param payload Raw GX bytes of the level
+     * @param parameters Format, size and any other decode inputs, hashed as bytes
+     */
+    static uint64_t makeKey(const uint8_t* payload, size_t payloadSize, const void* parameters, size_t parametersSize);
+
+    /**
+     * @brief Look up a level
+     * @return Mapping of the entry with pixels at kHeaderSize, or null on a miss
+     */
+    std::shared_ptr<const MappedFile> find(uint64_t key, uint16_t width, uint16_t height);
+
+    /**
+     * @brief Queue a decoded level to be written, evicting older entries to stay in budget
+     *
+     * Copies the pixels and returns at once; find() sees the entry once it is
+     * written. Dropped when too much is already waiting to be written.
+     */
+    void store(uint64_t key, uint16_t width, uint16_t height, const uint8_t* rgba, size_t size);
+
+    uint64_t sizeBytes() const;
+    const std::filesystem::path& directory() const { return m_directory; }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        uint64_t bytes = 0;
+        // Set when used since opening; written out by the destructor
+        std::filesystem::file_time_type lastUse;
+        bool touched = false;
+    };
+
+    struct PendingStore {
+        uint64_t key = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        std::vector<uint8_t> rgba;
+    };
+
+    std::filesystem::path entryPath(uint64_t key) const;
+    void scanDirectory();
+    void touchLocked(std::list<Entry>::iterator it);
+    void evictLocked(uint64_t incomingBytes);
+    void writerLoop();
+    void write(const PendingStore& pending);
+    void writeAccessTimes();
+
+    std::filesystem::path m_directory;
+    uint64_t m_maxBytes;
+
+    mutable std::mutex m_mutex;
+    // Most recently used first.
+    std::list<Entry> m_lru;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_entries;
+    uint64_t m_totalBytes = 0;
+
+    std::condition_variable m_writeCondition;
+    std::deque<PendingStore> m_writeQueue;
+    std::unordered_set<uint64_t> m_queuedKeys;
+    size_t m_queuedBytes = 0;
+    bool m_stopping = false;
+    std::thread m_writer;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_TEXTURE_CACHE_H
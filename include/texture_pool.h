@@ -0,0 +1,74 @@
+#ifndef SMSTRIKERS_TEXTURE_POOL_H
+#define SMSTRIKERS_TEXTURE_POOL_H
+
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SMStrikers {
+
+/**
+ * @brief Recycles GL texture objects together with their level storage
+ *
+ * Released textures are held back for a few frames, so a draw still in
+ * flight never competes with new uploads into the same texture, and then
+ * become idle. acquire() hands out an idle texture of the same size and
+ * internal format before creating a new one. While held-back and idle
+ * textures together exceed the byte limit passed to beginFrame(), idle ones
+ * are deleted a few per frame, never in the frame that released them.
+ *
+ * Needs a current GL context; call clear() before it goes away.
+ */
+class TexturePool {
+public:
+    struct Texture {
+        GLuint id = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        GLenum internalFormat = 0;
+        // Levels 0..allocatedLevels-1 have storage and need no glTexImage2D
+        uint32_t allocatedLevels = 0;
+    };
+
+    TexturePool() = default;
+    ~TexturePool() = default;
+
+    TexturePool(const TexturePool&) = delete;
+    TexturePool& operator=(const TexturePool&) = delete;
+
+    /**
+     * @brief Reuse an idle texture of this size and format, or create one
+     *
+     * Texture parameters are left as the previous user set them.
+     */
+    Texture acquire(uint16_t width, uint16_t height, GLenum internalFormat);
+    void release(const Texture& texture);
+
+    /**
+     * @brief Advance one frame: retire held-back textures and trim idle ones
+     * @param maxPooledBytes Storage kept in released textures before deleting some
+     */
+    void beginFrame(size_t maxPooledBytes);
+    void clear();
+
+private:
+    struct Entry {
+        Texture texture;
+        uint64_t releasedFrame = 0;
+    };
+
+    static uint64_t key(uint16_t width, uint16_t height, GLenum internalFormat);
+    static size_t storageBytes(const Texture& texture);
+
+    // Held-back and idle storage
+    size_t m_pooledBytes = 0;
+    uint64_t m_frame = 0;
+    std::vector<Entry> m_heldBack;
+    std::unordered_multimap<uint64_t, Entry> m_idle;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_TEXTURE_POOL_H
@@ -0,0 +1,64 @@
+#ifndef SMSTRIKERS_TEXTURE_UPLOADER_H
+#define SMSTRIKERS_TEXTURE_UPLOADER_H
+
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SMStrikers {
+
+/**
+ * @brief Streams texture pixels to the GPU through a ring of pixel buffers
+ *
+ * Rows are copied into a mapped pixel unpack buffer and handed to
+ * glTexSubImage2D from there, so the driver transfers them asynchronously
+ * instead of copying them out of client memory inside the call. Each buffer
+ * is fenced and only reused once the GPU is done with it.
+ *
+ * A byte budget, reset every frame by beginFrame(), bounds how much is
+ * uploaded per frame; callers resume a partially uploaded level on the next
+ * frame. Needs a current GL context; call clear() before it goes away.
+ */
+class TextureUploader {
+public:
+    TextureUploader() = default;
+    ~TextureUploader() = default;
+
+    TextureUploader(const TextureUploader&) = delete;
+    TextureUploader& operator=(const TextureUploader&) = delete;
+
+    void beginFrame(size_t budgetBytes);
+    bool hasBudget() const { return m_budgetLeft > 0; }
+
+    /**
+     * @brief Count bytes uploaded by other means against this frame's budget
+     */
+    void charge(size_t bytes);
+
+    /**
+     * @brief Upload rows of one RGBA8 level whose storage already exists
+     * @param pixels The whole level, tightly packed
+     * @return Rows uploaded starting at firstRow; fewer than the rest, possibly
+     *         none, when the budget or the free buffers run out
+     */
+    int uploadRows(GLuint texture, GLint level, int width, int height, int firstRow, const uint8_t* pixels);
+
+    void clear();
+
+private:
+    struct Buffer {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+    };
+
+    bool acquire(Buffer& buffer);
+
+    std::vector<Buffer> m_buffers;
+    size_t m_next = 0;
+    size_t m_budgetLeft = 0;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_TEXTURE_UPLOADER_H
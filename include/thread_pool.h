@@ -0,0 +1,62 @@
+#ifndef SMSTRIKERS_THREAD_POOL_H
+#define SMSTRIKERS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SMStrikers {
+
+/**
+ * @brief Fixed-size pool of worker threads for CPU-bound asset work
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Start the pool
+     * @param threadCount Number of workers, 0 to size the pool to the machine
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task to run on one of the workers
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Run body(i) for every i in [0, count) and wait for all of them
+     *
+     * The calling thread takes part in the work, so nested calls from inside
+     * a pool task cannot deadlock. The first exception thrown by body is
+     * rethrown on the calling thread.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    size_t threadCount() const { return m_workers.size(); }
+
+    /**
+     * @brief Process-wide pool sized to the machine
+     */
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_THREAD_POOL_H
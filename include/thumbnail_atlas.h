@@ -0,0 +1,71 @@
+#ifndef SMSTRIKERS_THUMBNAIL_ATLAS_H
+#define SMSTRIKERS_THUMBNAIL_ATLAS_H
+
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SMStrikers {
+
+/**
+ * @brief Packs small RGBA8 images into a few shared GL textures
+ *
+ * Each page is a square texture divided into equal cells; an image takes one
+ * cell and is drawn through its UV rectangle, so a grid of thumbnails binds
+ * one texture per page instead of one per image. Pages are created as cells
+ * run out and deleted once their last cell is freed.
+ *
+ * Needs a current GL context for add(), remove() and clear(); call clear()
+ * before the context goes away.
+ */
+class ThumbnailAtlas {
+public:
+    struct Slot {
+        GLuint texture = 0;
+        float u0 = 0.0f;
+        float v0 = 0.0f;
+        float u1 = 0.0f;
+        float v1 = 0.0f;
+    };
+
+    /**
+     * @param cellSize Largest image side that fits a cell
+     */
+    explicit ThumbnailAtlas(int cellSize);
+    ~ThumbnailAtlas() = default;
+
+    ThumbnailAtlas(const ThumbnailAtlas&) = delete;
+    ThumbnailAtlas& operator=(const ThumbnailAtlas&) = delete;
+
+    /**
+     * @brief Copy an image into a free cell
+     * @return Handle for slot() and remove(), or -1 if the image does not fit a cell
+     */
+    int add(const uint8_t* rgba, int width, int height);
+    void remove(int handle);
+    void clear();
+
+    const Slot& slot(int handle) const { return m_slots[handle]; }
+    // Storage of every allocated page, used or not
+    size_t gpuBytes() const;
+
+private:
+    struct Page {
+        GLuint texture = 0;
+        std::vector<int> freeCells;
+        int usedCells = 0;
+    };
+
+    int m_cellSize;
+    int m_cellStride;
+    int m_cellsPerRow;
+    std::vector<Page> m_pages;
+    // Handle -> slot; a handle encodes its page and cell
+    std::vector<Slot> m_slots;
+    std::vector<uint8_t> m_staging;
+};
+
+} // namespace SMStrikers
+
+#endif // SMSTRIKERS_THUMBNAIL_ATLAS_H
@@ -4,13 +4,20 @@
 #include <glad/gl.h>
 #include <imgui.h>
 #include <string>
+#include <string_view>
+#include <list>
 #include <memory>
 #include <array>
 #include <vector>
 #include "config.h"
 #include "asset_tree.h"
 #include "asset_tree_view.h"
+#include "asset_tree_watcher.h"
 #include "asset_loader.h"
+#include "background_loader.h"
+#include "texture_pool.h"
+#include "texture_uploader.h"
+#include "thumbnail_atlas.h"
 
 struct GLFWwindow;
 
@@ -107,11 +114,17 @@ private:
     static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset);
     
     // Asset management
-    void refreshAssetTree();
+    // fullScan ignores the saved asset index and lists every directory
+    void refreshAssetTree(bool fullScan = false);
+    void applyAssetTreeChanges();
+    void dropCachedBundles(std::string_view relativePath);
     void handleAssetSelection(const AssetNode* node);
     void openFolderPicker();
     void clearLoadedTextures();
-    void buildLoadedTextures(const TextureBundle& bundle);
+    void buildLoadedTextures(const std::shared_ptr<TextureBundle>& bundle);
+    void pollBackgroundLoad();
+    void schedulePrefetch(const AssetNode* node);
+    void storePrefetchedBundle(size_t targetIndex, std::shared_ptr<AssetLoadResult> result);
 
     bool m_initialized;
     bool m_noGui;
@@ -148,24 +161,81 @@ private:
     // Assets
     AssetTreeModel m_assetTreeModel;
     AssetTreeView m_assetTreeView;
+    AssetTreeWatcher m_assetTreeWatcher;
+    std::vector<AssetTreeChange> m_assetTreeChanges;
     AssetLoaderRegistry m_assetLoaders;
-    std::string m_selectedAssetPath;
+    std::shared_ptr<TextureCache> m_textureCache;
+    AssetNodeIndex m_selectedNode = kInvalidAssetNode;
     std::string m_lastLoadedPath;
     AssetLoadResult m_lastLoadResult;
     std::string m_lastLoaderName;
     bool m_hasLoadResult = false;
 
+    // Declared after the loaders and cache it uses so it stops first.
+    BackgroundLoader m_backgroundLoader;
+    uint64_t m_loadGeneration = 0;
+    bool m_loadInProgress = false;
+    std::string m_pendingLoadPath;
+    std::string m_pendingLoaderName;
+
+    // Neighbours of the selection being warmed at low priority
+    struct PrefetchTarget {
+        std::string path;
+        std::string loaderName;
+    };
+    uint64_t m_prefetchGeneration = 0;
+    std::vector<PrefetchTarget> m_prefetchTargets;
+
     struct LoadedTexture {
         uint32_t hash = 0;
         uint16_t width = 0;
         uint16_t height = 0;
         uint32_t format = 0;
         GLuint textureId = 0;
+        size_t imageIndex = 0;
+        uint32_t allocatedLevels = 0; // Levels with storage, possibly from a recycled texture
+        uint32_t residentLevels = 0;
+        int uploadedRows = 0; // Of level residentLevels, while it streams in
+        size_t gpuBytes = 0;
+        int thumbnailSlot = -1; // Handle into m_thumbnailAtlas
+        bool decoded = false;   // Level 0 and thumbnail decoded by the background loader
     };
+    void ensureTextureLevels(LoadedTexture& texture, uint32_t maxLevel);
+    bool isTextureReady(const LoadedTexture& texture) const;
+    void ensureThumbnail(LoadedTexture& texture);
+    void releaseTexture(LoadedTexture& texture);
+    // Release GL textures outside [keepBegin, keepEnd), except the selected one
+    void releaseDistantThumbnails(int keepBegin, int keepEnd);
     std::vector<LoadedTexture> m_loadedTextures;
+    std::shared_ptr<TextureBundle> m_loadedBundle;
     int m_selectedTextureIndex = 0;
+
+    // Recently viewed texture bundles, most recent first, kept together with
+    // their GL textures so reselecting one skips loading and uploading.
+    struct CachedBundle {
+        std::string path;
+        std::string loaderName;
+        AssetLoadResult result;
+        std::vector<LoadedTexture> textures;
+        int selectedTextureIndex = 0;
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+    };
+    void stashLoadedTextures();
+    bool restoreCachedBundle(std::string_view path);
+    void trimBundleCache();
+    void clearBundleCache();
+    std::list<CachedBundle> m_bundleCache;
     std::string m_loadedTexturePath;
+    ThumbnailAtlas m_thumbnailAtlas{TextureImage::kThumbnailSize};
+    TextureUploader m_textureUploader;
+    // Released textures wait here for reuse, up to Config::texturePoolMB
+    TexturePool m_texturePool;
     float m_thumbnailSize = 72.0f;
+    // Thumbnail range and selection whose GL textures were last kept resident
+    int m_residentThumbnailsBegin = -1;
+    int m_residentThumbnailsEnd = -1;
+    int m_residentSelectedIndex = -1;
     float m_textureZoom = 1.0f;
     ImVec2 m_texturePan = ImVec2(0.0f, 0.0f);
 
@@ -1,12 +1,81 @@
 #include "asset_loader.h"
+#include "log.h"
+#include "mapped_file.h"
+#include "texture_cache.h"
+#include "thread_pool.h"
 #include <algorithm>
+#include <array>
 #include <cctype>
-#include <fstream>
-#include <iostream>
+#include <cstring>
+#include <mutex>
 #include <sstream>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SMSTRIKERS_HAS_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SMSTRIKERS_TARGET_AVX2
+#else
+#define SMSTRIKERS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
 namespace SMStrikers {
 
+// Raw GX data of a texture's levels, starting with level 0. Reads them from the
+// bundle's mapping while it loads; releaseFile() then copies out only what is
+// still undecoded, so the file can change on disk after loading. Each level is
+// decoded once, the first time it is requested.
+// With a texture cache, a level found there is served from the cache entry's
+// mapping instead, and freshly decoded levels are added to it.
+class TextureMipChain {
+public:
+    struct Level {
+        size_t offset = 0;
+        size_t size = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+    };
+
+    // Levels and palette are located in file by their offsets.
+    TextureMipChain(std::shared_ptr<const MappedFile> file, uint32_t format, std::vector<Level> levels,
+                    size_t paletteOffset, uint32_t paletteEntries, bool cmprMsbFirst,
+                    std::shared_ptr<TextureCache> cache);
+
+    uint32_t levelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+    PixelView pixels(uint32_t level);
+    bool isDecoded(uint32_t level);
+    size_t heapBytes();
+    PixelView thumbnail(uint16_t width, uint16_t height);
+    // Copies the raw data of levels not decoded yet and drops the file.
+    void releaseFile();
+
+private:
+    uint64_t cacheKey(uint32_t level) const;
+
+    // Until releaseFile(), m_source points into m_file; after it, into
+    // m_data, which holds the undecoded levels back to back, then the
+    // palette for CI8.
+    std::shared_ptr<const MappedFile> m_file;
+    std::vector<uint8_t> m_data;
+    const uint8_t* m_source = nullptr;
+    uint32_t m_format;
+    std::vector<Level> m_levels;
+    size_t m_paletteOffset;
+    uint32_t m_paletteEntries;
+    bool m_cmprMsbFirst;
+    std::shared_ptr<TextureCache> m_cache;
+
+    std::mutex m_mutex;
+    std::vector<uint8_t> m_paletteRGBA;
+    std::vector<std::vector<uint8_t>> m_pixels;
+    std::vector<std::shared_ptr<const MappedFile>> m_cached;
+    std::vector<bool> m_decoded;
+    std::vector<uint8_t> m_thumbnail;
+    bool m_thumbnailBuilt = false;
+};
+
 namespace {
 
 enum GXTextureFormat {
@@ -21,7 +90,7 @@ enum GXTextureFormat {
     GXTex_CI8 = 8
 };
 
-uint32_t readU32BE(const std::vector<uint8_t>& data, size_t offset) {
+uint32_t readU32BE(const MappedFile& data, size_t offset) {
     return (static_cast<uint32_t>(data[offset]) << 24) |
            (static_cast<uint32_t>(data[offset + 1]) << 16) |
            (static_cast<uint32_t>(data[offset + 2]) << 8) |
@@ -29,7 +98,7 @@ uint32_t readU32BE(const std::vector<uint8_t>& data, size_t offset) {
 }
 
 
-uint16_t readU16BE(const std::vector<uint8_t>& data, size_t offset) {
+uint16_t readU16BE(const MappedFile& data, size_t offset) {
     return static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
 }
 
@@ -82,16 +151,31 @@ uint8_t expand4To8(uint8_t value) {
     return static_cast<uint8_t>((value << 4) | value);
 }
 
+// Expansion of an n-bit channel to 8 bits, rounded to nearest.
+template <int Bits>
+constexpr std::array<uint8_t, (1 << Bits)> makeExpandTable() {
+    constexpr int kMax = (1 << Bits) - 1;
+    std::array<uint8_t, (1 << Bits)> table{};
+    for (int value = 0; value <= kMax; ++value) {
+        table[value] = static_cast<uint8_t>((value * 255 + kMax / 2) / kMax);
+    }
+    return table;
+}
+
+constexpr auto kExpand3To8 = makeExpandTable<3>();
+constexpr auto kExpand5To8 = makeExpandTable<5>();
+constexpr auto kExpand6To8 = makeExpandTable<6>();
+
 uint8_t expand5To8(uint8_t value) {
-    return static_cast<uint8_t>((value * 255 + 15) / 31);
+    return kExpand5To8[value];
 }
 
 uint8_t expand6To8(uint8_t value) {
-    return static_cast<uint8_t>((value * 255 + 31) / 63);
+    return kExpand6To8[value];
 }
 
 uint8_t expand3To8(uint8_t value) {
-    return static_cast<uint8_t>((value * 255 + 3) / 7);
+    return kExpand3To8[value];
 }
 
 void decodeRGB565(uint16_t value, uint8_t& r, uint8_t& g, uint8_t& b) {
@@ -114,158 +198,174 @@ void decodeRGB5A3(uint16_t value, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& a
     }
 }
 
-void writePixel(std::vector<uint8_t>& out, int width, int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    size_t index = static_cast<size_t>((y * width + x) * 4);
-    out[index] = r;
-    out[index + 1] = g;
-    out[index + 2] = b;
-    out[index + 3] = a;
+void storePixel(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    dst[0] = r;
+    dst[1] = g;
+    dst[2] = b;
+    dst[3] = a;
 }
 
-void decodeI4(const uint8_t* data, int width, int height, std::vector<uint8_t>& out) {
-    TileInfo info{8, 8, 32};
-    int tilesX = (width + info.tileW - 1) / info.tileW;
-    int tilesY = (height + info.tileH - 1) / info.tileH;
-    size_t offset = 0;
-    for (int ty = 0; ty < tilesY; ++ty) {
-        for (int tx = 0; tx < tilesX; ++tx) {
-            const uint8_t* tile = data + offset;
-            for (int p = 0; p < info.tileW * info.tileH; ++p) {
-                uint8_t byte = tile[p / 2];
-                uint8_t nibble = (p % 2 == 0) ? (byte >> 4) : (byte & 0xF);
-                uint8_t intensity = expand4To8(nibble);
-                int x = (p % info.tileW) + tx * info.tileW;
-                int y = (p / info.tileW) + ty * info.tileH;
-                if (x < width && y < height) {
-                    writePixel(out, width, x, y, intensity, intensity, intensity, 255);
-                }
-            }
-            offset += info.bytesPerTile;
-        }
+struct ColorRGBA8 {
+    uint8_t r, g, b, a;
+};
+static_assert(sizeof(ColorRGBA8) == 4, "ColorRGBA8 must match the RGBA8 output layout");
+
+// Every 16-bit color decoded up front, so RGB565 and RGB5A3 pixels are a single
+// load and store. Filled from the constexpr channel tables on first use; a
+// 65536-step constant expression exceeds the default limits of Clang and MSVC.
+using ColorTable = std::array<ColorRGBA8, 65536>;
+
+template <typename Decode>
+std::unique_ptr<const ColorTable> makeColorTable(Decode decode) {
+    auto table = std::make_unique<ColorTable>();
+    for (uint32_t value = 0; value < table->size(); ++value) {
+        ColorRGBA8& color = (*table)[value];
+        decode(static_cast<uint16_t>(value), color);
     }
+    return table;
 }
 
-void decodeI8(const uint8_t* data, int width, int height, std::vector<uint8_t>& out, bool alphaOnly) {
-    TileInfo info{8, 4, 32};
-    int tilesX = (width + info.tileW - 1) / info.tileW;
-    int tilesY = (height + info.tileH - 1) / info.tileH;
-    size_t offset = 0;
-    for (int ty = 0; ty < tilesY; ++ty) {
-        for (int tx = 0; tx < tilesX; ++tx) {
-            const uint8_t* tile = data + offset;
-            for (int p = 0; p < info.tileW * info.tileH; ++p) {
-                uint8_t intensity = tile[p];
-                int x = (p % info.tileW) + tx * info.tileW;
-                int y = (p / info.tileW) + ty * info.tileH;
-                if (x < width && y < height) {
-                    uint8_t r = alphaOnly ? 255 : intensity;
-                    uint8_t g = alphaOnly ? 255 : intensity;
-                    uint8_t b = alphaOnly ? 255 : intensity;
-                    uint8_t a = alphaOnly ? intensity : 255;
-                    writePixel(out, width, x, y, r, g, b, a);
-                }
-            }
-            offset += info.bytesPerTile;
-        }
-    }
+const ColorTable& rgb565Table() {
+    static const std::unique_ptr<const ColorTable> table = makeColorTable([](uint16_t value, ColorRGBA8& color) {
+        decodeRGB565(value, color.r, color.g, color.b);
+        color.a = 255;
+    });
+    return *table;
 }
 
-void decodeIA8(const uint8_t* data, int width, int height, std::vector<uint8_t>& out) {
-    TileInfo info{4, 4, 32};
-    int tilesX = (width + info.tileW - 1) / info.tileW;
-    int tilesY = (height + info.tileH - 1) / info.tileH;
-    size_t offset = 0;
-    for (int ty = 0; ty < tilesY; ++ty) {
-        for (int tx = 0; tx < tilesX; ++tx) {
-            const uint8_t* tile = data + offset;
-            for (int p = 0; p < info.tileW * info.tileH; ++p) {
-                uint8_t intensity = tile[p * 2];
-                uint8_t alpha = tile[p * 2 + 1];
-                int x = (p % info.tileW) + tx * info.tileW;
-                int y = (p / info.tileW) + ty * info.tileH;
-                if (x < width && y < height) {
-                    writePixel(out, width, x, y, intensity, intensity, intensity, alpha);
-                }
-            }
-            offset += info.bytesPerTile;
-        }
-    }
+const ColorTable& rgb5A3Table() {
+    static const std::unique_ptr<const ColorTable> table = makeColorTable([](uint16_t value, ColorRGBA8& color) {
+        decodeRGB5A3(value, color.r, color.g, color.b, color.a);
+    });
+    return *table;
 }
 
-void decodeRGB16(const uint8_t* data, int width, int height, std::vector<uint8_t>& out, bool useRGB5A3) {
-    TileInfo info{4, 4, 32};
-    int tilesX = (width + info.tileW - 1) / info.tileW;
-    int tilesY = (height + info.tileH - 1) / info.tileH;
-    size_t offset = 0;
-    for (int ty = 0; ty < tilesY; ++ty) {
-        for (int tx = 0; tx < tilesX; ++tx) {
-            const uint8_t* tile = data + offset;
-            for (int p = 0; p < info.tileW * info.tileH; ++p) {
-                uint16_t value = readU16BE(tile + p * 2);
-                uint8_t r = 0, g = 0, b = 0, a = 255;
-                if (useRGB5A3) {
-                    decodeRGB5A3(value, r, g, b, a);
-                } else {
-                    decodeRGB565(value, r, g, b);
-                }
-                int x = (p % info.tileW) + tx * info.tileW;
-                int y = (p / info.tileW) + ty * info.tileH;
-                if (x < width && y < height) {
-                    writePixel(out, width, x, y, r, g, b, a);
-                }
-            }
-            offset += info.bytesPerTile;
-        }
-    }
+void storePixel(uint8_t* dst, const ColorRGBA8& color) {
+    std::memcpy(dst, &color, sizeof(color));
 }
 
-void decodeRGBA8(const uint8_t* data, int width, int height, std::vector<uint8_t>& out) {
-    TileInfo info{4, 4, 64};
-    int tilesX = (width + info.tileW - 1) / info.tileW;
-    int tilesY = (height + info.tileH - 1) / info.tileH;
-    size_t offset = 0;
-    for (int ty = 0; ty < tilesY; ++ty) {
-        for (int tx = 0; tx < tilesX; ++tx) {
-            const uint8_t* tile = data + offset;
-            const uint8_t* ar = tile;
-            const uint8_t* gb = tile + 32;
-            for (int p = 0; p < info.tileW * info.tileH; ++p) {
-                uint8_t a = ar[p * 2];
-                uint8_t r = ar[p * 2 + 1];
-                uint8_t g = gb[p * 2];
-                uint8_t b = gb[p * 2 + 1];
-                int x = (p % info.tileW) + tx * info.tileW;
-                int y = (p / info.tileW) + ty * info.tileH;
-                if (x < width && y < height) {
-                    writePixel(out, width, x, y, r, g, b, a);
-                }
-            }
-            offset += info.bytesPerTile;
-        }
+// Tile geometry of each GX format. Decoders are instantiated per layout so the
+// row loops below have compile-time trip counts.
+constexpr TileInfo kTileI4{8, 8, 32};
+constexpr TileInfo kTileI8{8, 4, 32};
+constexpr TileInfo kTileIA8{4, 4, 32};
+constexpr TileInfo kTileRGB16{4, 4, 32};
+constexpr TileInfo kTileRGBA8{4, 4, 64};
+constexpr TileInfo kTileCI8{8, 4, 32};
+constexpr TileInfo kTileCMPR{8, 8, 32};
+
+// Pixel converters: decode pixel p (row-major within its tile) to RGBA at dst.
+struct I4Pixel {
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        uint8_t byte = tile[p >> 1];
+        uint8_t intensity = expand4To8((p & 1) == 0 ? (byte >> 4) : (byte & 0xF));
+        storePixel(dst, intensity, intensity, intensity, 255);
+    }
+};
+
+struct I8Pixel {
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        storePixel(dst, tile[p], tile[p], tile[p], 255);
+    }
+};
+
+struct A8Pixel {
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        storePixel(dst, 255, 255, 255, tile[p]);
+    }
+};
+
+struct IA8Pixel {
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        storePixel(dst, tile[p * 2], tile[p * 2], tile[p * 2], tile[p * 2 + 1]);
+    }
+};
+
+struct RGB565Pixel {
+    const ColorTable& colors = rgb565Table();
+
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        storePixel(dst, colors[readU16BE(tile + p * 2)]);
     }
+};
+
+struct RGB5A3Pixel {
+    const ColorTable& colors = rgb5A3Table();
+
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        storePixel(dst, colors[readU16BE(tile + p * 2)]);
+    }
+};
+
+// RGBA8 tiles hold 16 AR pairs followed by 16 GB pairs.
+struct RGBA8Pixel {
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        storePixel(dst, tile[p * 2 + 1], tile[32 + p * 2], tile[33 + p * 2], tile[p * 2]);
+    }
+};
+
+// Converts a big-endian RGB5A3 palette to the 256-entry RGBA8 table CI8Pixel
+// reads. Indices past the end of the palette decode as opaque black.
+std::vector<uint8_t> expandCI8Palette(const uint8_t* entries, uint32_t count) {
+    static constexpr ColorRGBA8 kMissing{0, 0, 0, 255};
+    const ColorTable& colors = rgb5A3Table();
+    std::vector<uint8_t> table(256 * sizeof(ColorRGBA8));
+    for (uint32_t index = 0; index < 256; ++index) {
+        const ColorRGBA8& color = index < count ? colors[readU16BE(entries + index * 2)] : kMissing;
+        storePixel(table.data() + index * sizeof(ColorRGBA8), color);
+    }
+    return table;
 }
 
-void decodeCI8(const uint8_t* data, int width, int height, const std::vector<uint16_t>& palette, std::vector<uint8_t>& out) {
-    TileInfo info{8, 4, 32};
-    int tilesX = (width + info.tileW - 1) / info.tileW;
-    int tilesY = (height + info.tileH - 1) / info.tileH;
-    size_t offset = 0;
-    for (int ty = 0; ty < tilesY; ++ty) {
-        for (int tx = 0; tx < tilesX; ++tx) {
-            const uint8_t* tile = data + offset;
-            for (int p = 0; p < info.tileW * info.tileH; ++p) {
-                uint8_t index = tile[p];
-                uint8_t r = 0, g = 0, b = 0, a = 255;
-                if (index < palette.size()) {
-                    decodeRGB5A3(palette[index], r, g, b, a);
+struct CI8Pixel {
+    const uint8_t* palette;
+
+    void operator()(const uint8_t* tile, int p, uint8_t* dst) const {
+        std::memcpy(dst, palette + tile[p] * sizeof(ColorRGBA8), sizeof(ColorRGBA8));
+    }
+};
+
+// Walks tile rows [tyBegin, tyEnd) of a GX texture in row-major order. Tile
+// rows write disjoint output rows, so ranges can be decoded concurrently.
+// Interior tiles are always fully in bounds, so their rows are written
+// straight into the output without per-pixel checks; only the right and
+// bottom edge tiles are clipped.
+template <const TileInfo& Info, typename PixelDecoder>
+void decodeTiled(const uint8_t* data, int width, int height, uint8_t* out, int tyBegin, int tyEnd,
+                 const PixelDecoder& decodePixel) {
+    constexpr int tileW = Info.tileW;
+    constexpr int tileH = Info.tileH;
+    const int tilesX = (width + tileW - 1) / tileW;
+    const int fullTilesX = width / tileW;
+    const size_t stride = static_cast<size_t>(width) * 4;
+    const uint8_t* tile = data + static_cast<size_t>(tyBegin) * tilesX * Info.bytesPerTile;
+    for (int ty = tyBegin; ty < tyEnd; ++ty) {
+        const int y0 = ty * tileH;
+        uint8_t* tileRow = out + static_cast<size_t>(y0) * stride;
+        if (y0 + tileH <= height) {
+            for (int tx = 0; tx < fullTilesX; ++tx) {
+                uint8_t* dst = tileRow + static_cast<size_t>(tx) * tileW * 4;
+                for (int py = 0; py < tileH; ++py) {
+                    uint8_t* row = dst + py * stride;
+                    for (int px = 0; px < tileW; ++px) {
+                        decodePixel(tile, py * tileW + px, row + px * 4);
+                    }
                 }
-                int x = (p % info.tileW) + tx * info.tileW;
-                int y = (p / info.tileW) + ty * info.tileH;
-                if (x < width && y < height) {
-                    writePixel(out, width, x, y, r, g, b, a);
+                tile += Info.bytesPerTile;
+            }
+        }
+        for (int tx = (y0 + tileH <= height) ? fullTilesX : 0; tx < tilesX; ++tx) {
+            const int x0 = tx * tileW;
+            const int rows = std::min(tileH, height - y0);
+            const int cols = std::min(tileW, width - x0);
+            uint8_t* dst = tileRow + static_cast<size_t>(x0) * 4;
+            for (int py = 0; py < rows; ++py) {
+                uint8_t* row = dst + py * stride;
+                for (int px = 0; px < cols; ++px) {
+                    decodePixel(tile, py * tileW + px, row + px * 4);
                 }
             }
-            offset += info.bytesPerTile;
+            tile += Info.bytesPerTile;
         }
     }
 }
@@ -311,36 +411,251 @@ void decodeCMPRBlock(const uint8_t* block, uint8_t colors[4][4]) {
     }
 }
 
-void decodeCMPR(const uint8_t* data, int width, int height, std::vector<uint8_t>& out, bool msbFirst) {
-    TileInfo info{8, 8, 32};
+// Decodes one 8x8 CMPR tile (four 4x4 sub-blocks) to RGBA at dst, rows stride bytes apart.
+using CMPRTileDecoder = void (*)(const uint8_t* tile, bool msbFirst, uint8_t* dst, size_t stride);
+
+// Scalar reference decoder; the SIMD tile decoders below must match it bit for bit.
+[[maybe_unused]] void decodeCMPRTileScalar(const uint8_t* tile, bool msbFirst, uint8_t* dst, size_t stride) {
+    for (int blockIndex = 0; blockIndex < 4; ++blockIndex) {
+        const uint8_t* block = tile + blockIndex * 8;
+        uint8_t colors[4][4];
+        decodeCMPRBlock(block, colors);
+        uint32_t indices = readU32BE(block + 4);
+        uint8_t* blockDst = dst + static_cast<size_t>(blockIndex >> 1) * 4 * stride + (blockIndex & 1) * 16;
+        for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex) {
+            int shift = msbFirst ? (30 - pixelIndex * 2) : (pixelIndex * 2);
+            uint8_t code = static_cast<uint8_t>((indices >> shift) & 0x3);
+            std::copy_n(colors[code], 4, blockDst + (pixelIndex >> 2) * stride + (pixelIndex & 3) * 4);
+        }
+    }
+}
+
+#ifdef SMSTRIKERS_HAS_SSE2
+
+inline __m128i selectBits(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Builds the 4-color palettes of all four sub-blocks of a tile at once. Each
+// 16-bit lane holds one endpoint, ordered c0,c1 per block, so swapping adjacent
+// lanes lines up the opposite endpoint for the interpolation terms.
+inline void buildCMPRPalettes(const uint8_t* tile, __m128i palettes[4]) {
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tile));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tile + 16));
+    __m128i ends = _mm_unpacklo_epi64(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0)),
+                                      _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0)));
+    ends = _mm_or_si128(_mm_slli_epi16(ends, 8), _mm_srli_epi16(ends, 8));
+
+    auto swapPairs = [](__m128i v) {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    };
+
+    // (v * 527 + 23) >> 6 and (v * 259 + 33) >> 6 are exact for expand5To8/expand6To8.
+    const __m128i r = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(ends, 11),
+                                                                   _mm_set1_epi16(527)),
+                                                   _mm_set1_epi16(23)), 6);
+    const __m128i g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(ends, 5),
+                                                                                 _mm_set1_epi16(0x3F)),
+                                                                   _mm_set1_epi16(259)),
+                                                   _mm_set1_epi16(33)), 6);
+    const __m128i b = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(ends, _mm_set1_epi16(0x1F)),
+                                                                   _mm_set1_epi16(527)),
+                                                   _mm_set1_epi16(23)), 6);
+
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+    __m128i fourColor = _mm_cmpgt_epi16(_mm_xor_si128(ends, bias), _mm_xor_si128(swapPairs(ends), bias));
+    fourColor = _mm_shufflehi_epi16(_mm_shufflelo_epi16(fourColor, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128i evenLanes = _mm_set_epi16(0, -1, 0, -1, 0, -1, 0, -1);
+
+    // Even lanes become color 2, odd lanes color 3. Division by 3 is exact via
+    // mulhi for the sums that can occur (<= 765).
+    auto interpolate = [&](__m128i c) {
+        const __m128i swapped = swapPairs(c);
+        const __m128i third = _mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(c, c), swapped), _mm_set1_epi16(21846));
+        const __m128i half = _mm_and_si128(_mm_srli_epi16(_mm_add_epi16(c, swapped), 1), evenLanes);
+        return selectBits(fourColor, third, half);
+    };
+    const __m128i er = interpolate(r);
+    const __m128i eg = interpolate(g);
+    const __m128i eb = interpolate(b);
+    const __m128i ea = _mm_and_si128(_mm_or_si128(fourColor, evenLanes), _mm_set1_epi16(0xFF));
+
+    const __m128i baseRG = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+    const __m128i baseBA = _mm_or_si128(b, _mm_set1_epi16(static_cast<short>(0xFF00)));
+    const __m128i extraRG = _mm_or_si128(er, _mm_slli_epi16(eg, 8));
+    const __m128i extraBA = _mm_or_si128(eb, _mm_slli_epi16(ea, 8));
+
+    const __m128i baseLo = _mm_unpacklo_epi16(baseRG, baseBA);
+    const __m128i baseHi = _mm_unpackhi_epi16(baseRG, baseBA);
+    const __m128i extraLo = _mm_unpacklo_epi16(extraRG, extraBA);
+    const __m128i extraHi = _mm_unpackhi_epi16(extraRG, extraBA);
+
+    palettes[0] = _mm_unpacklo_epi64(baseLo, extraLo);
+    palettes[1] = _mm_unpackhi_epi64(baseLo, extraLo);
+    palettes[2] = _mm_unpacklo_epi64(baseHi, extraHi);
+    palettes[3] = _mm_unpackhi_epi64(baseHi, extraHi);
+}
+
+void decodeCMPRTileSSE2(const uint8_t* tile, bool msbFirst, uint8_t* dst, size_t stride) {
+    __m128i palettes[4];
+    buildCMPRPalettes(tile, palettes);
+
+    // Per-lane masks for the high and low bit of each pixel's 2-bit code within a row byte.
+    const __m128i hiMask = msbFirst ? _mm_setr_epi32(0x80, 0x20, 0x08, 0x02) : _mm_setr_epi32(0x02, 0x08, 0x20, 0x80);
+    const __m128i loMask = msbFirst ? _mm_setr_epi32(0x40, 0x10, 0x04, 0x01) : _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+
+    for (int blockIndex = 0; blockIndex < 4; ++blockIndex) {
+        const uint8_t* indices = tile + blockIndex * 8 + 4;
+        const __m128i p0 = _mm_shuffle_epi32(palettes[blockIndex], 0x00);
+        const __m128i p1 = _mm_shuffle_epi32(palettes[blockIndex], 0x55);
+        const __m128i p2 = _mm_shuffle_epi32(palettes[blockIndex], 0xAA);
+        const __m128i p3 = _mm_shuffle_epi32(palettes[blockIndex], 0xFF);
+        uint8_t* blockDst = dst + static_cast<size_t>(blockIndex >> 1) * 4 * stride + (blockIndex & 1) * 16;
+        for (int py = 0; py < 4; ++py) {
+            const __m128i row = _mm_set1_epi32(indices[msbFirst ? py : 3 - py]);
+            const __m128i lowBit = _mm_cmpeq_epi32(_mm_and_si128(row, loMask), loMask);
+            const __m128i highBit = _mm_cmpeq_epi32(_mm_and_si128(row, hiMask), hiMask);
+            const __m128i pixels = selectBits(highBit, selectBits(lowBit, p3, p2), selectBits(lowBit, p1, p0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(blockDst + py * stride), pixels);
+        }
+    }
+}
+
+SMSTRIKERS_TARGET_AVX2
+void decodeCMPRTileAVX2(const uint8_t* tile, bool msbFirst, uint8_t* dst, size_t stride) {
+    __m128i palettes[4];
+    buildCMPRPalettes(tile, palettes);
+
+    // Two rows (8 pixels) per step: shift each 2-bit code into place and use it
+    // directly as the permute index into the block palette.
+    const __m256i shiftsTop = msbFirst ? _mm256_setr_epi32(30, 28, 26, 24, 22, 20, 18, 16)
+                                       : _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m256i shiftsBottom = msbFirst ? _mm256_setr_epi32(14, 12, 10, 8, 6, 4, 2, 0)
+                                          : _mm256_setr_epi32(16, 18, 20, 22, 24, 26, 28, 30);
+    const __m256i codeMask = _mm256_set1_epi32(0x3);
+
+    for (int blockIndex = 0; blockIndex < 4; ++blockIndex) {
+        const __m256i palette = _mm256_castsi128_si256(palettes[blockIndex]);
+        const __m256i indices = _mm256_set1_epi32(static_cast<int>(readU32BE(tile + blockIndex * 8 + 4)));
+        uint8_t* blockDst = dst + static_cast<size_t>(blockIndex >> 1) * 4 * stride + (blockIndex & 1) * 16;
+        for (int half = 0; half < 2; ++half) {
+            const __m256i codes = _mm256_and_si256(_mm256_srlv_epi32(indices, half == 0 ? shiftsTop : shiftsBottom), codeMask);
+            const __m256i pixels = _mm256_permutevar8x32_epi32(palette, codes);
+            uint8_t* rowDst = blockDst + static_cast<size_t>(half * 2) * stride;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rowDst), _mm256_castsi256_si128(pixels));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rowDst + stride), _mm256_extracti128_si256(pixels, 1));
+        }
+    }
+}
+
+bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#ifndef NDEBUG
+// Compares a tile decoder with the scalar one on generated tiles, in both bit
+// orders. Blocks alternate between c0 > c1 and c0 <= c1, the latter with its
+// transparent fourth color, and some have equal endpoints.
+bool matchesScalarCMPR(CMPRTileDecoder decodeTile) {
+    uint32_t seed = 0x2545F491u;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed;
+    };
+    uint8_t tile[32];
+    uint8_t expected[8 * 8 * 4];
+    uint8_t actual[8 * 8 * 4];
+    for (int sample = 0; sample < 64; ++sample) {
+        for (int blockIndex = 0; blockIndex < 4; ++blockIndex) {
+            uint8_t* block = tile + blockIndex * 8;
+            uint16_t color0 = static_cast<uint16_t>(next() >> 16);
+            uint16_t color1 = static_cast<uint16_t>(next() >> 16);
+            const bool fourColor = ((sample + blockIndex) & 1) != 0;
+            if ((color0 > color1) != fourColor) {
+                std::swap(color0, color1);
+            }
+            if (!fourColor && sample % 8 == 0) {
+                color1 = color0;
+            }
+            const uint32_t indices = next();
+            block[0] = static_cast<uint8_t>(color0 >> 8);
+            block[1] = static_cast<uint8_t>(color0);
+            block[2] = static_cast<uint8_t>(color1 >> 8);
+            block[3] = static_cast<uint8_t>(color1);
+            for (int byte = 0; byte < 4; ++byte) {
+                block[4 + byte] = static_cast<uint8_t>(indices >> (24 - byte * 8));
+            }
+        }
+        for (bool msbFirst : {false, true}) {
+            decodeCMPRTileScalar(tile, msbFirst, expected, 8 * 4);
+            decodeTile(tile, msbFirst, actual, 8 * 4);
+            if (std::memcmp(expected, actual, sizeof(expected)) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+#endif // SMSTRIKERS_HAS_SSE2
+
+CMPRTileDecoder selectCMPRTileDecoder() {
+#ifdef SMSTRIKERS_HAS_SSE2
+    static const CMPRTileDecoder decoder = [] {
+        CMPRTileDecoder selected = cpuSupportsAVX2() ? &decodeCMPRTileAVX2 : &decodeCMPRTileSSE2;
+#ifndef NDEBUG
+        if (!matchesScalarCMPR(&decodeCMPRTileSSE2) || !matchesScalarCMPR(selected)) {
+            SMSTRIKERS_LOG_ERROR("SIMD CMPR decoder disagrees with the scalar one; decoding CMPR without SIMD");
+            selected = &decodeCMPRTileScalar;
+        }
+#endif
+        return selected;
+    }();
+    return decoder;
+#else
+    return &decodeCMPRTileScalar;
+#endif
+}
+
+void decodeCMPR(const uint8_t* data, int width, int height, uint8_t* out, int tyBegin, int tyEnd, bool msbFirst) {
+    const TileInfo& info = kTileCMPR;
+    const CMPRTileDecoder decodeTile = selectCMPRTileDecoder();
     int tilesX = (width + info.tileW - 1) / info.tileW;
-    int tilesY = (height + info.tileH - 1) / info.tileH;
-    size_t offset = 0;
-    for (int ty = 0; ty < tilesY; ++ty) {
+    size_t stride = static_cast<size_t>(width) * 4;
+    uint8_t edgeTile[8 * 8 * 4];
+    size_t offset = static_cast<size_t>(tyBegin) * tilesX * info.bytesPerTile;
+    for (int ty = tyBegin; ty < tyEnd; ++ty) {
         for (int tx = 0; tx < tilesX; ++tx) {
             const uint8_t* tile = data + offset;
-            for (int blockY = 0; blockY < 2; ++blockY) {
-                for (int blockX = 0; blockX < 2; ++blockX) {
-                    const uint8_t* block = tile + (blockY * 2 + blockX) * 8;
-                    uint8_t colors[4][4];
-                    decodeCMPRBlock(block, colors);
-                    uint32_t indices = readU32BE(block + 4);
-                    for (int py = 0; py < 4; ++py) {
-                        for (int px = 0; px < 4; ++px) {
-                            int pixelIndex = py * 4 + px;
-                            int shift = msbFirst ? (30 - pixelIndex * 2) : (pixelIndex * 2);
-                            uint8_t code = static_cast<uint8_t>((indices >> shift) & 0x3);
-                            int x = tx * info.tileW + blockX * 4 + px;
-                            int y = ty * info.tileH + blockY * 4 + py;
-                            if (x < width && y < height) {
-                                writePixel(out, width, x, y,
-                                           colors[code][0],
-                                           colors[code][1],
-                                           colors[code][2],
-                                           colors[code][3]);
-                            }
-                        }
-                    }
+            int x0 = tx * info.tileW;
+            int y0 = ty * info.tileH;
+            uint8_t* dst = out + static_cast<size_t>(y0) * stride + static_cast<size_t>(x0) * 4;
+            if (x0 + info.tileW <= width && y0 + info.tileH <= height) {
+                decodeTile(tile, msbFirst, dst, stride);
+            } else {
+                decodeTile(tile, msbFirst, edgeTile, info.tileW * 4);
+                int copyW = std::min(info.tileW, width - x0);
+                int copyH = std::min(info.tileH, height - y0);
+                for (int row = 0; row < copyH; ++row) {
+                    std::copy_n(edgeTile + row * info.tileW * 4, copyW * 4, dst + row * stride);
                 }
             }
             offset += info.bytesPerTile;
@@ -348,74 +663,261 @@ void decodeCMPR(const uint8_t* data, int width, int height, std::vector<uint8_t>
     }
 }
 
-uint64_t computeEdgeEnergy(const std::vector<uint8_t>& rgba, int width, int height) {
+uint64_t computeTileEdgeEnergy(const uint8_t* rgba, int size) {
     uint64_t energy = 0;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            size_t index = static_cast<size_t>((y * width + x) * 4);
-            uint8_t r = rgba[index];
-            uint8_t g = rgba[index + 1];
-            uint8_t b = rgba[index + 2];
-            if (x + 1 < width) {
-                size_t right = static_cast<size_t>((y * width + x + 1) * 4);
-                energy += std::abs(rgba[right] - r);
-                energy += std::abs(rgba[right + 1] - g);
-                energy += std::abs(rgba[right + 2] - b);
-            }
-            if (y + 1 < height) {
-                size_t down = static_cast<size_t>(((y + 1) * width + x) * 4);
-                energy += std::abs(rgba[down] - r);
-                energy += std::abs(rgba[down + 1] - g);
-                energy += std::abs(rgba[down + 2] - b);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const uint8_t* pixel = rgba + (y * size + x) * 4;
+            for (int c = 0; c < 3; ++c) {
+                if (x + 1 < size) {
+                    energy += static_cast<uint64_t>(std::abs(pixel[4 + c] - pixel[c]));
+                }
+                if (y + 1 < size) {
+                    energy += static_cast<uint64_t>(std::abs(pixel[size * 4 + c] - pixel[c]));
+                }
             }
         }
     }
     return energy;
 }
 
-bool decodeTexture(uint32_t format, int width, int height, const uint8_t* data,
-                   const std::vector<uint16_t>& palette, std::vector<uint8_t>& out) {
-    out.assign(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, 0);
+// Decides the CMPR index bit order from a handful of tiles instead of decoding
+// whole images twice. The wrong order rotates every 4x4 block by 180 degrees,
+// which shows up as higher edge energy across the block seams inside a tile.
+// Samples accumulate across the CMPR textures of a bundle until enough tiles
+// have told the two orders apart.
+class CMPRBitOrderProbe {
+public:
+    static constexpr int kTilesPerTexture = 16;
+    static constexpr int kDecisiveTiles = 8;
+
+    void sample(const uint8_t* data, int width, int height) {
+        if (decided()) {
+            return;
+        }
+        const CMPRTileDecoder decodeTile = selectCMPRTileDecoder();
+        int tilesX = (width + 7) / 8;
+        int tilesY = (height + 7) / 8;
+        int totalTiles = tilesX * tilesY;
+        int samples = std::min(kTilesPerTexture, totalTiles);
+        uint8_t msbTile[8 * 8 * 4];
+        uint8_t lsbTile[8 * 8 * 4];
+        for (int i = 0; i < samples; ++i) {
+            int tileIndex = static_cast<int>((static_cast<int64_t>(i) * totalTiles + totalTiles / 2) / samples);
+            const uint8_t* tile = data + static_cast<size_t>(tileIndex) * 32;
+            decodeTile(tile, true, msbTile, 8 * 4);
+            decodeTile(tile, false, lsbTile, 8 * 4);
+            uint64_t msbEnergy = computeTileEdgeEnergy(msbTile, 8);
+            uint64_t lsbEnergy = computeTileEdgeEnergy(lsbTile, 8);
+            if (msbEnergy != lsbEnergy) {
+                m_msbEnergy += msbEnergy;
+                m_lsbEnergy += lsbEnergy;
+                m_decisiveTiles += 1;
+            }
+        }
+    }
+
+    bool decided() const { return m_decisiveTiles >= kDecisiveTiles; }
+    bool sampled() const { return m_decisiveTiles > 0; }
+    bool msbFirst() const { return m_msbEnergy <= m_lsbEnergy; }
+
+private:
+    uint64_t m_msbEnergy = 0;
+    uint64_t m_lsbEnergy = 0;
+    int m_decisiveTiles = 0;
+};
+
+// Bit order decisions of previously loaded bundles, keyed by path and
+// invalidated when the file's size or modification time changes.
+class CMPRBitOrderCache {
+public:
+    struct Key {
+        std::string path;
+        uintmax_t fileSize = 0;
+        std::filesystem::file_time_type writeTime{};
+    };
+
+    CMPRBitOrder find(const Key& key) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key.path);
+        if (it == m_entries.end() || it->second.fileSize != key.fileSize || it->second.writeTime != key.writeTime) {
+            return CMPRBitOrder::Unknown;
+        }
+        return it->second.order;
+    }
+
+    void store(const Key& key, CMPRBitOrder order) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries[key.path] = {key.fileSize, key.writeTime, order};
+    }
+
+private:
+    struct Entry {
+        uintmax_t fileSize = 0;
+        std::filesystem::file_time_type writeTime{};
+        CMPRBitOrder order = CMPRBitOrder::Unknown;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+};
+
+CMPRBitOrderCache& cmprBitOrderCache() {
+    static CMPRBitOrderCache cache;
+    return cache;
+}
+
+const TileInfo* tileInfoForFormat(uint32_t format) {
     switch (format) {
     case GXTex_I4:
-        decodeI4(data, width, height, out);
-        return true;
+        return &kTileI4;
     case GXTex_I8:
-        decodeI8(data, width, height, out, false);
-        return true;
     case GXTex_A8:
-        decodeI8(data, width, height, out, true);
-        return true;
+        return &kTileI8;
     case GXTex_IA8:
-        decodeIA8(data, width, height, out);
-        return true;
+        return &kTileIA8;
     case GXTex_RGB565:
-        decodeRGB16(data, width, height, out, false);
-        return true;
     case GXTex_RGB5A3:
-        decodeRGB16(data, width, height, out, true);
-        return true;
+        return &kTileRGB16;
     case GXTex_RGBA8:
-        decodeRGBA8(data, width, height, out);
-        return true;
+        return &kTileRGBA8;
     case GXTex_CI8:
-        decodeCI8(data, width, height, palette, out);
-        return true;
-    case GXTex_CMPR: {
-        std::vector<uint8_t> optionA;
-        std::vector<uint8_t> optionB;
-        optionA.assign(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, 0);
-        optionB.assign(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, 0);
-        decodeCMPR(data, width, height, optionA, true);
-        decodeCMPR(data, width, height, optionB, false);
-        uint64_t energyA = computeEdgeEnergy(optionA, width, height);
-        uint64_t energyB = computeEdgeEnergy(optionB, width, height);
-        out = (energyA <= energyB) ? std::move(optionA) : std::move(optionB);
-        return true;
+        return &kTileCI8;
+    case GXTex_CMPR:
+        return &kTileCMPR;
+    default:
+        return nullptr;
     }
+}
+
+void decodeTileRows(uint32_t format, int width, int height, const uint8_t* data, const uint8_t* palette,
+                    bool cmprMsbFirst, uint8_t* out, int tyBegin, int tyEnd) {
+    switch (format) {
+    case GXTex_I4:
+        decodeTiled<kTileI4>(data, width, height, out, tyBegin, tyEnd, I4Pixel{});
+        break;
+    case GXTex_I8:
+        decodeTiled<kTileI8>(data, width, height, out, tyBegin, tyEnd, I8Pixel{});
+        break;
+    case GXTex_A8:
+        decodeTiled<kTileI8>(data, width, height, out, tyBegin, tyEnd, A8Pixel{});
+        break;
+    case GXTex_IA8:
+        decodeTiled<kTileIA8>(data, width, height, out, tyBegin, tyEnd, IA8Pixel{});
+        break;
+    case GXTex_RGB565:
+        decodeTiled<kTileRGB16>(data, width, height, out, tyBegin, tyEnd, RGB565Pixel{});
+        break;
+    case GXTex_RGB5A3:
+        decodeTiled<kTileRGB16>(data, width, height, out, tyBegin, tyEnd, RGB5A3Pixel{});
+        break;
+    case GXTex_RGBA8:
+        decodeTiled<kTileRGBA8>(data, width, height, out, tyBegin, tyEnd, RGBA8Pixel{});
+        break;
+    case GXTex_CI8:
+        decodeTiled<kTileCI8>(data, width, height, out, tyBegin, tyEnd, CI8Pixel{palette});
+        break;
+    case GXTex_CMPR:
+        decodeCMPR(data, width, height, out, tyBegin, tyEnd, cmprMsbFirst);
+        break;
     default:
+        break;
+    }
+}
+
+// Images at least this large have their tile rows split across the thread
+// pool, in chunks of roughly kParallelDecodeChunkPixels each.
+constexpr size_t kParallelDecodeMinPixels = 512 * 512;
+constexpr size_t kParallelDecodeChunkPixels = 64 * 1024;
+
+// palette is the table from expandCI8Palette and is only read for CI8.
+bool decodeTexture(uint32_t format, int width, int height, const uint8_t* data,
+                   const uint8_t* palette, bool cmprMsbFirst, std::vector<uint8_t>& out) {
+    const TileInfo* info = tileInfoForFormat(format);
+    if (!info || (format == GXTex_CI8 && !palette)) {
         return false;
     }
+    out.assign(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, 0);
+
+    const int tilesY = (height + info->tileH - 1) / info->tileH;
+    const size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    if (pixels < kParallelDecodeMinPixels || tilesY < 2) {
+        decodeTileRows(format, width, height, data, palette, cmprMsbFirst, out.data(), 0, tilesY);
+        return true;
+    }
+
+    const size_t tileRowPixels = static_cast<size_t>(width) * static_cast<size_t>(info->tileH);
+    const int rowsPerChunk = static_cast<int>(std::max<size_t>(1, kParallelDecodeChunkPixels / tileRowPixels));
+    const int chunks = (tilesY + rowsPerChunk - 1) / rowsPerChunk;
+    ThreadPool::shared().parallelFor(static_cast<size_t>(chunks), [&](size_t chunk) {
+        int tyBegin = static_cast<int>(chunk) * rowsPerChunk;
+        int tyEnd = std::min(tilesY, tyBegin + rowsPerChunk);
+        decodeTileRows(format, width, height, data, palette, cmprMsbFirst, out.data(), tyBegin, tyEnd);
+    });
+    return true;
+}
+
+// Averages each block of source pixels into one destination pixel. The
+// blocks tile the source exactly, so every texel counts once whatever the
+// ratio; the destination must not be larger than the source.
+void boxDownsample(const uint8_t* src, int srcWidth, int srcHeight, uint8_t* dst, int dstWidth, int dstHeight) {
+    for (int dy = 0; dy < dstHeight; ++dy) {
+        const int y0 = dy * srcHeight / dstHeight;
+        const int y1 = (dy + 1) * srcHeight / dstHeight;
+        for (int dx = 0; dx < dstWidth; ++dx) {
+            const int x0 = dx * srcWidth / dstWidth;
+            const int x1 = (dx + 1) * srcWidth / dstWidth;
+            uint32_t sum[4] = {};
+            for (int y = y0; y < y1; ++y) {
+                const uint8_t* row = src + (static_cast<size_t>(y) * srcWidth + x0) * 4;
+                for (int x = x0; x < x1; ++x, row += 4) {
+                    sum[0] += row[0];
+                    sum[1] += row[1];
+                    sum[2] += row[2];
+                    sum[3] += row[3];
+                }
+            }
+            const uint32_t count = static_cast<uint32_t>((y1 - y0) * (x1 - x0));
+            uint8_t* out = dst + (static_cast<size_t>(dy) * dstWidth + dx) * 4;
+            for (int c = 0; c < 4; ++c) {
+                out[c] = static_cast<uint8_t>((sum[c] + count / 2) / count);
+            }
+        }
+    }
+}
+
+// Bytes of one level padded to whole tiles, or 0 for an unknown format.
+size_t mipLevelSize(uint32_t format, int width, int height) {
+    const TileInfo* info = tileInfoForFormat(format);
+    if (!info) {
+        return 0;
+    }
+    size_t tilesX = static_cast<size_t>((width + info->tileW - 1) / info->tileW);
+    size_t tilesY = static_cast<size_t>((height + info->tileH - 1) / info->tileH);
+    return tilesX * tilesY * static_cast<size_t>(info->bytesPerTile);
+}
+
+// Locates levels 0..numLevels-1 in the file. Each level is padded to whole
+// tiles; levels that would run past the end of the file are dropped, so an
+// empty result means not even level 0 can be decoded.
+std::vector<TextureMipChain::Level> mipLevelLayout(uint32_t format, int width, int height, uint32_t numLevels,
+                                                   size_t dataStart, size_t fileSize) {
+    std::vector<TextureMipChain::Level> levels;
+    if (!tileInfoForFormat(format)) {
+        return levels;
+    }
+    size_t offset = dataStart;
+    for (uint32_t level = 0; level < numLevels; ++level) {
+        int levelWidth = std::max(1, width >> level);
+        int levelHeight = std::max(1, height >> level);
+        size_t levelSize = mipLevelSize(format, levelWidth, levelHeight);
+        if (offset + levelSize > fileSize) {
+            break;
+        }
+        levels.push_back({offset, levelSize, static_cast<uint16_t>(levelWidth), static_cast<uint16_t>(levelHeight)});
+        offset += levelSize;
+    }
+    return levels;
 }
 
 std::string toLower(std::string value) {
@@ -446,7 +948,7 @@ AssetLoadResult loadFileStats(const std::filesystem::path& path, const char* lab
     }
 }
 
-AssetLoadResult loadTextureBundle(const std::filesystem::path& path) {
+AssetLoadResult loadTextureBundle(const std::filesystem::path& path, const AssetLoadOptions& options) {
     AssetLoadResult result;
     try {
         if (!std::filesystem::exists(path)) {
@@ -460,32 +962,27 @@ AssetLoadResult loadTextureBundle(const std::filesystem::path& path) {
 
         result.fileSize = std::filesystem::file_size(path);
 
-        std::ifstream file(path, std::ios::binary);
-        if (!file) {
-            result.message = "Failed to open file";
+        // Parsing and eager decoding read straight from the mapping. Before
+        // returning, textures copy out the levels left to decode later, so
+        // nothing touches the file afterwards; a bundle rewritten on disk
+        // while it is shown cannot fault the viewer.
+        std::shared_ptr<const MappedFile> fileData = MappedFile::open(path, result.message);
+        if (!fileData) {
             return result;
         }
-
-        file.seekg(0, std::ios::end);
-        std::streamoff size = file.tellg();
-        if (size <= 0) {
-            result.message = "Empty file";
-            return result;
-        }
-        file.seekg(0, std::ios::beg);
-
-        std::vector<uint8_t> data(static_cast<size_t>(size));
-        file.read(reinterpret_cast<char*>(data.data()), size);
-        if (!file) {
-            result.message = "Failed to read file";
-            return result;
+        if (options.readAhead) {
+            fileData->willNeed();
         }
+        const MappedFile& data = *fileData;
 
         if (data.size() < 0x20) {
             result.message = "File too small for GLT header";
             return result;
         }
 
+        const CMPRBitOrderCache::Key bitOrderKey{path.string(), result.fileSize, std::filesystem::last_write_time(path)};
+        const CMPRBitOrder knownBitOrder = cmprBitOrderCache().find(bitOrderKey);
+
         struct GltLayout {
             size_t dictOffset;
             size_t headerSize;
@@ -540,116 +1037,182 @@ AssetLoadResult loadTextureBundle(const std::filesystem::path& path) {
             return matches;
         };
 
-        auto parseBundle = [&](const GltLayout& layout) -> std::shared_ptr<TextureBundle> {
-            uint32_t numTextures = readU32BE(data, 4);
-            if (numTextures == 0 || numTextures > 10000) {
-                return {};
+        // Reads and validates one dictionary entry and its texture header.
+        // Only header fields are touched; without an entry to fill, nothing is
+        // allocated either, so layouts can be scored cheaply.
+        struct GltEntry {
+            TextureImage image;
+            std::vector<TextureMipChain::Level> levels;
+            size_t paletteStart = 0;
+        };
+        auto readEntry = [&](const GltLayout& layout, size_t textureDataOffset, uint32_t index,
+                             GltEntry* entry) -> bool {
+            size_t entryOffset = layout.dictOffset + static_cast<size_t>(index) * 0x10;
+            uint32_t hash = readU32BE(data, entryOffset);
+            uint32_t offset = readU32BE(data, entryOffset + 4);
+            uint32_t fileSize = readU32BE(data, entryOffset + 8);
+
+            size_t textureOffset = textureDataOffset + offset;
+            if (textureOffset + layout.headerSize > data.size()) {
+                return false;
             }
-            size_t dictSize = static_cast<size_t>(numTextures) * 0x10;
-            if (layout.dictOffset + dictSize > data.size()) {
-                return {};
+            if (fileSize != 0 && textureOffset + fileSize > data.size()) {
+                return false;
             }
-            size_t textureDataOffset = layout.dictOffset + dictSize;
 
-            auto bundle = std::make_shared<TextureBundle>();
-            bundle->textures.reserve(numTextures);
+            uint32_t numLevels = readU32BE(data, textureOffset);
+            uint32_t format = readU32BE(data, textureOffset + 4);
+            uint16_t width = readU16BE(data, textureOffset + layout.widthOffset);
+            uint16_t height = readU16BE(data, textureOffset + layout.heightOffset);
+            uint32_t numEntries = layout.hasNumEntries ? readU32BE(data, textureOffset + layout.numEntriesOffset) : 0;
 
-            for (uint32_t i = 0; i < numTextures; ++i) {
-                size_t entryOffset = layout.dictOffset + static_cast<size_t>(i) * 0x10;
-                uint32_t hash = readU32BE(data, entryOffset);
-                uint32_t offset = readU32BE(data, entryOffset + 4);
-                uint32_t fileSize = readU32BE(data, entryOffset + 8);
+            if (numLevels == 0) {
+                return false;
+            }
+            if (format > GXTex_CI8 || width == 0 || height == 0 || width > 4096 || height > 4096) {
+                return false;
+            }
 
-                std::cout << "GLT dict[" << i << "] hash=0x" << std::hex << hash
-                          << " offset=0x" << offset << " size=0x" << fileSize
-                          << std::dec << "\n";
+            size_t textureDataSize = gcTextureSize(format, width, height, static_cast<int>(numLevels));
+            size_t textureDataStart = textureOffset + layout.headerSize;
+            size_t paletteStart = textureDataStart + textureDataSize;
 
-                size_t textureOffset = textureDataOffset + offset;
-                if (textureOffset + layout.headerSize > data.size()) {
-                    continue;
-                }
-                if (fileSize != 0 && textureOffset + fileSize > data.size()) {
-                    continue;
-                }
+            if (textureDataStart + textureDataSize > data.size()) {
+                return false;
+            }
+            if (numEntries > 0 && paletteStart + static_cast<size_t>(numEntries) * 2 > data.size()) {
+                return false;
+            }
 
-                uint32_t numLevels = readU32BE(data, textureOffset);
-                uint32_t format = readU32BE(data, textureOffset + 4);
-                uint16_t width = readU16BE(data, textureOffset + layout.widthOffset);
-                uint16_t height = readU16BE(data, textureOffset + layout.heightOffset);
-                uint32_t numEntries = layout.hasNumEntries ? readU32BE(data, textureOffset + layout.numEntriesOffset) : 0;
+            // Level 0 must fit for the entry to be decodable at all.
+            const size_t level0Size = mipLevelSize(format, width, height);
+            if (level0Size == 0 || textureDataStart + level0Size > data.size()) {
+                return false;
+            }
+            if (!entry) {
+                return true;
+            }
 
-                if (numLevels == 0) {
-                    continue;
-                }
-                if (format > GXTex_CI8 || width == 0 || height == 0 || width > 4096 || height > 4096) {
-                    continue;
-                }
+            entry->levels = mipLevelLayout(format, width, height, numLevels, textureDataStart, data.size());
+            entry->image.hash = hash;
+            entry->image.width = width;
+            entry->image.height = height;
+            entry->image.format = format;
+            entry->image.numLevels = numLevels;
+            entry->image.paletteEntries = numEntries;
+            entry->paletteStart = paletteStart;
+            return true;
+        };
 
-                size_t textureDataSize = gcTextureSize(format, width, height, static_cast<int>(numLevels));
-                size_t textureDataStart = textureOffset + layout.headerSize;
-                size_t paletteStart = textureDataStart + textureDataSize;
+        auto dictionaryBounds = [&](const GltLayout& layout, uint32_t& numTextures, size_t& textureDataOffset) {
+            numTextures = readU32BE(data, 4);
+            if (numTextures == 0 || numTextures > 10000) {
+                return false;
+            }
+            size_t dictSize = static_cast<size_t>(numTextures) * 0x10;
+            if (layout.dictOffset + dictSize > data.size()) {
+                return false;
+            }
+            textureDataOffset = layout.dictOffset + dictSize;
+            return true;
+        };
 
-                if (textureDataStart + textureDataSize > data.size()) {
-                    continue;
+        // Layouts are chosen by whether any entry validates, so this stops at
+        // the first one that does.
+        auto hasValidEntry = [&](const GltLayout& layout) -> bool {
+            uint32_t numTextures = 0;
+            size_t textureDataOffset = 0;
+            if (!dictionaryBounds(layout, numTextures, textureDataOffset)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < numTextures; ++i) {
+                if (readEntry(layout, textureDataOffset, i, nullptr)) {
+                    return true;
                 }
+            }
+            return false;
+        };
 
-                std::vector<uint16_t> palette;
-                if (numEntries > 0) {
-                    palette.reserve(numEntries);
-                    size_t paletteBytes = static_cast<size_t>(numEntries) * 2;
-                    if (paletteStart + paletteBytes > data.size()) {
-                        continue;
-                    }
-                    for (uint32_t p = 0; p < numEntries; ++p) {
-                        palette.push_back(readU16BE(data, paletteStart + p * 2));
-                    }
-                }
+        auto parseBundle = [&](const GltLayout& layout) -> std::shared_ptr<TextureBundle> {
+            uint32_t numTextures = 0;
+            size_t textureDataOffset = 0;
+            if (!dictionaryBounds(layout, numTextures, textureDataOffset)) {
+                return {};
+            }
 
-                TextureImage image;
-                image.hash = hash;
-                image.width = width;
-                image.height = height;
-                image.format = format;
-                image.numLevels = numLevels;
-                image.paletteEntries = numEntries;
+            std::vector<GltEntry> entries;
+            entries.reserve(numTextures);
+            CMPRBitOrderProbe bitOrderProbe;
+
+            for (uint32_t i = 0; i < numTextures; ++i) {
+                size_t entryOffset = layout.dictOffset + static_cast<size_t>(i) * 0x10;
+                SMSTRIKERS_LOG_TRACE("GLT dict[" << i << "] hash=0x" << std::hex << readU32BE(data, entryOffset)
+                                     << " offset=0x" << readU32BE(data, entryOffset + 4)
+                                     << " size=0x" << readU32BE(data, entryOffset + 8));
 
-                if (!decodeTexture(format, width, height, data.data() + textureDataStart, palette, image.rgba)) {
+                GltEntry entry;
+                if (!readEntry(layout, textureDataOffset, i, &entry)) {
                     continue;
                 }
-
-                bundle->textures.push_back(std::move(image));
+                if (entry.image.format == GXTex_CMPR && knownBitOrder == CMPRBitOrder::Unknown) {
+                    bitOrderProbe.sample(data.data() + entry.levels.front().offset, entry.image.width,
+                                         entry.image.height);
+                }
+                entries.push_back(std::move(entry));
             }
 
-            if (bundle->textures.empty()) {
+            if (entries.empty()) {
                 return {};
             }
+
+            auto bundle = std::make_shared<TextureBundle>();
+            bundle->cmprBitOrder = knownBitOrder;
+            if (bitOrderProbe.sampled()) {
+                bundle->cmprBitOrder = bitOrderProbe.msbFirst() ? CMPRBitOrder::MsbFirst : CMPRBitOrder::LsbFirst;
+            }
+            const bool cmprMsbFirst = bundle->cmprBitOrder != CMPRBitOrder::LsbFirst;
+
+            // Pixels are left to TextureMipChain, which decodes each level on request.
+            bundle->textures.reserve(entries.size());
+            for (GltEntry& entry : entries) {
+                entry.image.mipChain = std::make_shared<TextureMipChain>(
+                    fileData, entry.image.format, std::move(entry.levels), entry.paletteStart,
+                    entry.image.paletteEntries, cmprMsbFirst, options.textureCache);
+                bundle->textures.push_back(std::move(entry.image));
+            }
             return bundle;
         };
 
+        // Pick the layout from header checks alone, then parse the bundle once.
         const GltLayout layout20 {0x20, 0x20, 0x0E, 0x10, 0x14, true, "layout20"};
-        auto bundle = parseBundle(layout20);
-        if (bundle) {
-            std::cout << "GLT parsed using " << layout20.label << ": " << bundle->textures.size() << " textures\n";
+        const GltLayout layout10a {0x10, 0x10, 0x0C, 0x0E, 0, false, "layout10a"};
+        const GltLayout layout10b {0x10, 0x10, 0x0E, 0x10, 0, false, "layout10b"};
+        const GltLayout* chosen = nullptr;
+        int matchesA = 0;
+        int matchesB = 0;
+        if (hasValidEntry(layout20)) {
+            chosen = &layout20;
         } else {
-            const GltLayout layout10a {0x10, 0x10, 0x0C, 0x0E, 0, false, "layout10a"};
-            const GltLayout layout10b {0x10, 0x10, 0x0E, 0x10, 0, false, "layout10b"};
-            int matchesA = countFileSizeMatches(layout10a);
-            int matchesB = countFileSizeMatches(layout10b);
+            matchesA = countFileSizeMatches(layout10a);
+            matchesB = countFileSizeMatches(layout10b);
             const GltLayout* preferred = (matchesB > matchesA) ? &layout10b : &layout10a;
-
-            bundle = parseBundle(*preferred);
-            if (!bundle && matchesA == matchesB) {
-                const GltLayout* fallback = (preferred == &layout10a) ? &layout10b : &layout10a;
-                bundle = parseBundle(*fallback);
-                if (bundle) {
-                    preferred = fallback;
-                }
+            const GltLayout* fallback = (preferred == &layout10a) ? &layout10b : &layout10a;
+            if (hasValidEntry(*preferred)) {
+                chosen = preferred;
+            } else if (matchesA == matchesB && hasValidEntry(*fallback)) {
+                chosen = fallback;
             }
+        }
 
-            if (bundle) {
-                std::cout << "GLT parsed using " << preferred->label << ": " << bundle->textures.size()
-                          << " textures (matches " << matchesA << ", " << matchesB << ")\n";
-            }
+        std::shared_ptr<TextureBundle> bundle;
+        if (chosen) {
+            bundle = parseBundle(*chosen);
+        }
+        if (bundle && chosen == &layout20) {
+            SMSTRIKERS_LOG_INFO("GLT parsed using " << chosen->label << ": " << bundle->textures.size() << " textures");
+        } else if (bundle) {
+            SMSTRIKERS_LOG_INFO("GLT parsed using " << chosen->label << ": " << bundle->textures.size()
+                                << " textures (matches " << matchesA << ", " << matchesB << ")");
         }
 
         if (!bundle) {
@@ -657,6 +1220,20 @@ AssetLoadResult loadTextureBundle(const std::filesystem::path& path) {
             return result;
         }
 
+        // Textures are independent, so an eager load spreads them over the pool.
+        if (options.decodeTextures) {
+            ThreadPool::shared().parallelFor(bundle->textures.size(), [&](size_t i) {
+                bundle->textures[i].pixels();
+            });
+        }
+        for (TextureImage& texture : bundle->textures) {
+            texture.mipChain->releaseFile();
+        }
+
+        if (knownBitOrder == CMPRBitOrder::Unknown && bundle->cmprBitOrder != CMPRBitOrder::Unknown) {
+            cmprBitOrderCache().store(bitOrderKey, bundle->cmprBitOrder);
+        }
+
         result.success = true;
         result.textureBundle = bundle;
         std::ostringstream message;
@@ -673,8 +1250,8 @@ AssetLoadResult loadTextureBundle(const std::filesystem::path& path) {
 }
 class GltLoader final : public IAssetLoader {
 public:
-    AssetLoadResult load(const std::filesystem::path& path) const override {
-        return loadTextureBundle(path);
+    AssetLoadResult load(const std::filesystem::path& path, const AssetLoadOptions& options) const override {
+        return loadTextureBundle(path, options);
     }
     const char* name() const override { return "GLT Loader"; }
     const char* extension() const override { return ".glt"; }
@@ -682,7 +1259,7 @@ public:
 
 class GlgLoader final : public IAssetLoader {
 public:
-    AssetLoadResult load(const std::filesystem::path& path) const override {
+    AssetLoadResult load(const std::filesystem::path& path, const AssetLoadOptions&) const override {
         return loadFileStats(path, "model bundle");
     }
     const char* name() const override { return "GLG Loader"; }
@@ -691,6 +1268,205 @@ public:
 
 } // namespace
 
+TextureMipChain::TextureMipChain(std::shared_ptr<const MappedFile> file, uint32_t format, std::vector<Level> levels,
+                                 size_t paletteOffset, uint32_t paletteEntries, bool cmprMsbFirst,
+                                 std::shared_ptr<TextureCache> cache)
+    : m_file(std::move(file))
+    , m_source(m_file->data())
+    , m_format(format)
+    , m_levels(std::move(levels))
+    , m_paletteOffset(paletteOffset)
+    , m_paletteEntries(paletteEntries)
+    , m_cmprMsbFirst(cmprMsbFirst)
+    , m_cache(std::move(cache))
+    , m_pixels(m_levels.size())
+    , m_cached(m_levels.size())
+    , m_decoded(m_levels.size(), false)
+{
+}
+
+void TextureMipChain::releaseFile() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) {
+        return;
+    }
+
+    // Levels are contiguous in the file; copy the span of those still to be
+    // decoded, usually all but level 0 after an eager load.
+    size_t dataStart = SIZE_MAX;
+    size_t dataEnd = 0;
+    for (size_t level = 0; level < m_levels.size(); ++level) {
+        if (!m_decoded[level]) {
+            dataStart = std::min(dataStart, m_levels[level].offset);
+            dataEnd = std::max(dataEnd, m_levels[level].offset + m_levels[level].size);
+        }
+    }
+    if (dataEnd > 0) {
+        // Later cache keys hash the raw palette, so it is kept even when
+        // already expanded.
+        const size_t paletteBytes = m_format == GXTex_CI8 ? static_cast<size_t>(m_paletteEntries) * 2 : 0;
+        m_data.reserve(dataEnd - dataStart + paletteBytes);
+        m_data.assign(m_source + dataStart, m_source + dataEnd);
+        for (size_t level = 0; level < m_levels.size(); ++level) {
+            if (!m_decoded[level]) {
+                m_levels[level].offset -= dataStart;
+            }
+        }
+        m_data.insert(m_data.end(), m_source + m_paletteOffset, m_source + m_paletteOffset + paletteBytes);
+        m_paletteOffset = dataEnd - dataStart;
+    }
+    m_source = m_data.data();
+    m_file.reset();
+}
+
+uint64_t TextureMipChain::cacheKey(uint32_t level) const {
+    const Level& info = m_levels[level];
+    const uint8_t parameters[] = {
+        static_cast<uint8_t>(m_format),
+        static_cast<uint8_t>(info.width), static_cast<uint8_t>(info.width >> 8),
+        static_cast<uint8_t>(info.height), static_cast<uint8_t>(info.height >> 8),
+        static_cast<uint8_t>(m_format == GXTex_CMPR && m_cmprMsbFirst),
+    };
+    uint64_t key = TextureCache::makeKey(m_source + info.offset, info.size, parameters, sizeof(parameters));
+    if (m_format == GXTex_CI8) {
+        key = TextureCache::makeKey(m_source + m_paletteOffset, static_cast<size_t>(m_paletteEntries) * 2,
+                                    &key, sizeof(key));
+    }
+    return key;
+}
+
+PixelView TextureMipChain::pixels(uint32_t level) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool store = false;
+    uint64_t key = 0;
+    const Level& info = m_levels[level];
+    if (!m_decoded[level]) {
+        m_decoded[level] = true;
+        if (m_cache) {
+            key = cacheKey(level);
+            m_cached[level] = m_cache->find(key, info.width, info.height);
+        }
+
+        if (!m_cached[level]) {
+            // The palette is shared by all levels, so it is converted only once.
+            if (m_format == GXTex_CI8 && m_paletteRGBA.empty()) {
+                m_paletteRGBA = expandCI8Palette(m_source + m_paletteOffset, m_paletteEntries);
+            }
+            const uint8_t* palette = m_paletteRGBA.empty() ? nullptr : m_paletteRGBA.data();
+            if (!decodeTexture(m_format, info.width, info.height, m_source + info.offset, palette,
+                               m_cmprMsbFirst, m_pixels[level])) {
+                m_pixels[level].clear();
+            } else {
+                store = m_cache != nullptr;
+            }
+        }
+    }
+
+    PixelView view(m_pixels[level].data(), m_pixels[level].size());
+    if (const auto& cached = m_cached[level]) {
+        view = PixelView(cached->data() + TextureCache::kHeaderSize, cached->size() - TextureCache::kHeaderSize);
+    }
+    // A decoded level never changes again, so it is handed to the cache
+    // without holding up other threads waiting on this texture.
+    lock.unlock();
+    if (store) {
+        m_cache->store(key, info.width, info.height, view.data(), view.size());
+    }
+    return view;
+}
+
+bool TextureMipChain::isDecoded(uint32_t level) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_decoded[level];
+}
+
+size_t TextureMipChain::heapBytes() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t bytes = m_data.size() + m_paletteRGBA.size() + m_thumbnail.size();
+    for (const auto& pixels : m_pixels) {
+        bytes += pixels.size();
+    }
+    return bytes;
+}
+
+PixelView TextureMipChain::thumbnail(uint16_t width, uint16_t height) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_thumbnailBuilt) {
+            return PixelView(m_thumbnail.data(), m_thumbnail.size());
+        }
+    }
+
+    // Filter the smallest level that still covers the thumbnail, which is
+    // cheaper to decode than level 0 when the file has mips.
+    uint32_t level = 0;
+    while (level + 1 < m_levels.size() && m_levels[level + 1].width >= width && m_levels[level + 1].height >= height) {
+        ++level;
+    }
+    const Level& info = m_levels[level];
+    PixelView source = pixels(level);
+    std::vector<uint8_t> thumbnail;
+    if (source.size() == static_cast<size_t>(info.width) * info.height * 4) {
+        thumbnail.resize(static_cast<size_t>(width) * height * 4);
+        boxDownsample(source.data(), info.width, info.height, thumbnail.data(), width, height);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_thumbnailBuilt) {
+        m_thumbnail = std::move(thumbnail);
+        m_thumbnailBuilt = true;
+    }
+    return PixelView(m_thumbnail.data(), m_thumbnail.size());
+}
+
+uint32_t TextureImage::levelCount() const {
+    return mipChain ? mipChain->levelCount() : 0;
+}
+
+uint16_t TextureImage::levelWidth(uint32_t level) const {
+    return static_cast<uint16_t>(std::max(1, width >> level));
+}
+
+uint16_t TextureImage::levelHeight(uint32_t level) const {
+    return static_cast<uint16_t>(std::max(1, height >> level));
+}
+
+PixelView TextureImage::levelPixels(uint32_t level) const {
+    if (level >= levelCount()) {
+        return {};
+    }
+    return mipChain->pixels(level);
+}
+
+bool TextureImage::isLevelDecoded(uint32_t level) const {
+    return level < levelCount() && mipChain->isDecoded(level);
+}
+
+size_t TextureImage::heapBytes() const {
+    return mipChain ? mipChain->heapBytes() : 0;
+}
+
+uint16_t TextureImage::thumbnailWidth() const {
+    if (width <= kThumbnailSize && height <= kThumbnailSize) {
+        return width;
+    }
+    return static_cast<uint16_t>(std::max(1, width * kThumbnailSize / std::max(width, height)));
+}
+
+uint16_t TextureImage::thumbnailHeight() const {
+    if (width <= kThumbnailSize && height <= kThumbnailSize) {
+        return height;
+    }
+    return static_cast<uint16_t>(std::max(1, height * kThumbnailSize / std::max(width, height)));
+}
+
+PixelView TextureImage::thumbnailPixels() const {
+    if (levelCount() == 0 || width == 0 || height == 0) {
+        return {};
+    }
+    return mipChain->thumbnail(thumbnailWidth(), thumbnailHeight());
+}
+
 AssetLoaderRegistry::AssetLoaderRegistry() {
     registerLoader(std::make_unique<GltLoader>());
     registerLoader(std::make_unique<GlgLoader>());
@@ -1,7 +1,17 @@
 #include "asset_tree.h"
+#include "log.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
 #include <algorithm>
+#include <atomic>
 #include <cctype>
-#include <iostream>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <utility>
 
 namespace SMStrikers {
 
@@ -18,143 +28,777 @@ bool isFolderKind(AssetKind kind) {
     return kind == AssetKind::Folder;
 }
 
-bool nodeSort(const AssetNode& a, const AssetNode& b) {
+// Scanner output, before it is flattened into AssetNodes. Folders without
+// loadable files are kept, so the tree can be saved as an index.
+struct ScanNode {
+    std::string name;
+    AssetKind kind = AssetKind::File;
+    std::vector<ScanNode> children;
+    // Folders only: modification time in file clock ticks, and whether a
+    // loadable file lies somewhere below
+    int64_t modified = 0;
+    bool hasLoadable = false;
+};
+
+// Never equal to a real modification time, so the folder is listed next time.
+constexpr int64_t kUnknownModified = ScannedDirectory::kUnknownModified;
+
+// A directory changed this recently may change again within the same clock
+// tick, unnoticed by its modification time; such folders are not trusted.
+constexpr auto kModifiedSettleTime = std::chrono::seconds(2);
+
+bool nodeSort(const ScanNode& a, const ScanNode& b) {
     if (isFolderKind(a.kind) != isFolderKind(b.kind)) {
         return isFolderKind(a.kind);
     }
     return a.name < b.name;
 }
 
-const AssetNode* findNodeRecursive(const std::vector<AssetNode>& nodes, const std::string& relativePath) {
-    for (const auto& node : nodes) {
-        if (node.relativePath == relativePath) {
-            return &node;
+struct ScanTask {
+    ScanNode* node = nullptr;
+    std::filesystem::path path;
+    // Same folder in the saved index, if it has one
+    const ScanNode* cached = nullptr;
+};
+
+int64_t directoryModified(const std::filesystem::path& path) {
+    std::error_code ec;
+    const auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec || std::filesystem::file_time_type::clock::now() - modified < kModifiedSettleTime) {
+        return kUnknownModified;
+    }
+    return static_cast<int64_t>(modified.time_since_epoch().count());
+}
+
+const ScanNode* findCachedFolder(const ScanNode* cached, const std::string& name) {
+    if (!cached) {
+        return nullptr;
+    }
+    ScanNode probe;
+    probe.name = name;
+    probe.kind = AssetKind::Folder;
+    auto it = std::lower_bound(cached->children.begin(), cached->children.end(), probe, nodeSort);
+    return it != cached->children.end() && isFolderKind(it->kind) && it->name == name ? &*it : nullptr;
+}
+
+// Lists directories on every thread of the shared pool. Each thread owns a
+// deque: it pushes the subdirectories it finds and pops its newest task, so
+// it walks depth first. Idle threads steal the oldest task of another thread,
+// which tends to be the largest unscanned subtree.
+class DirectoryScan {
+public:
+    explicit DirectoryScan(size_t threadCount)
+        : m_queues(threadCount)
+    {
+    }
+
+    void push(size_t thread, ScanTask task) {
+        m_pending.fetch_add(1);
+        {
+            Queue& queue = m_queues[thread];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        wake(false);
+    }
+
+    void run(size_t thread) {
+        for (;;) {
+            // Read before looking for work, so a task pushed after the search
+            // came up empty still wakes this thread.
+            const uint64_t wakeups = m_wakeups.load();
+            ScanTask task;
+            if (pop(thread, task) || steal(thread, task)) {
+                scan(thread, task);
+                if (m_pending.fetch_sub(1) == 1) {
+                    wake(true);
+                }
+                continue;
+            }
+
+            // Idle threads sleep until a task is pushed or the scan is done,
+            // rather than spin while others wait on slow directory listings.
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_idleCondition.wait(lock, [&]() { return m_pending.load() == 0 || m_wakeups.load() != wakeups; });
+            if (m_pending.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    bool failed(std::string& error) {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        error = m_error;
+        return !m_error.empty();
+    }
+
+    size_t listedCount() const { return m_listed.load(); }
+    size_t reusedCount() const { return m_reused.load(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<ScanTask> tasks;
+    };
+
+    bool pop(size_t thread, ScanTask& task) {
+        Queue& queue = m_queues[thread];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    void wake(bool all) {
+        {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            m_wakeups.fetch_add(1);
+        }
+        if (all) {
+            m_idleCondition.notify_all();
+        } else {
+            m_idleCondition.notify_one();
+        }
+    }
+
+    bool steal(size_t thread, ScanTask& task) {
+        for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+            Queue& victim = m_queues[(thread + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void scan(size_t thread, const ScanTask& task) {
+        // Children are only appended while listing; their addresses are
+        // stable once the subdirectory tasks below are queued.
+        std::vector<std::pair<size_t, std::filesystem::path>> subdirectories;
+        std::vector<ScanNode>& children = task.node->children;
+
+        // Read before listing, so a change made during the listing shows up
+        // as a mismatch next time.
+        task.node->modified = directoryModified(task.path);
+        if (task.cached && task.node->modified != kUnknownModified && task.cached->modified == task.node->modified) {
+            // Entries were neither added, removed nor renamed since the index
+            // was written; only the subdirectories need checking.
+            m_reused.fetch_add(1);
+            children.reserve(task.cached->children.size());
+            for (const ScanNode& cachedChild : task.cached->children) {
+                ScanNode child;
+                child.name = cachedChild.name;
+                child.kind = cachedChild.kind;
+                children.push_back(std::move(child));
+            }
+            for (size_t index = 0; index < children.size(); ++index) {
+                if (isFolderKind(children[index].kind)) {
+                    push(thread, {&children[index], task.path / children[index].name, &task.cached->children[index]});
+                }
+            }
+            return;
+        }
+
+        m_listed.fetch_add(1);
+        try {
+            for (const auto& entry : std::filesystem::directory_iterator(task.path)) {
+                ScanNode child;
+                if (entry.is_directory()) {
+                    child.kind = AssetKind::Folder;
+                    subdirectories.emplace_back(children.size(), entry.path());
+                } else if (entry.is_regular_file()) {
+                    child.kind = assetKindFromExtension(toLower(entry.path().extension().string()));
+                    if (!isLoadable(child.kind)) {
+                        continue;
+                    }
+                } else {
+                    continue;
+                }
+                child.name = entry.path().filename().string();
+                children.push_back(std::move(child));
+            }
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            if (m_error.empty()) {
+                m_error = e.what();
+            }
+            return;
+        }
+
+        for (auto& [index, path] : subdirectories) {
+            const ScanNode* cached = findCachedFolder(task.cached, children[index].name);
+            push(thread, {&children[index], std::move(path), cached});
+        }
+    }
+
+    std::vector<Queue> m_queues;
+    // Tasks queued or running; the scan is over when it drops to zero.
+    std::atomic<size_t> m_pending{0};
+    // Bumped under m_idleMutex by every push and by the end of the scan
+    std::atomic<uint64_t> m_wakeups{0};
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCondition;
+    std::atomic<size_t> m_listed{0};
+    std::atomic<size_t> m_reused{0};
+    std::mutex m_errorMutex;
+    std::string m_error;
+};
+
+struct ScanResult {
+    size_t listed = 0; // Directories read from disk
+    size_t reused = 0; // Directories taken over from the index
+};
+
+bool scanDirectoryTree(const std::filesystem::path& rootPath, const ScanNode* cachedRoot, ScanNode& root,
+                       ScanResult& result, std::string& error) {
+    ThreadPool& pool = ThreadPool::shared();
+    DirectoryScan scan(pool.threadCount() + 1);
+    scan.push(0, {&root, rootPath, cachedRoot});
+    pool.parallelFor(pool.threadCount() + 1, [&](size_t thread) {
+        scan.run(thread);
+    });
+    result.listed = scan.listedCount();
+    result.reused = scan.reusedCount();
+    return !scan.failed(error);
+}
+
+// Sorting here rather than during the scan keeps the result independent of
+// thread timing. Files only get this far when loadable.
+bool sortAndMark(ScanNode& node) {
+    if (!isFolderKind(node.kind)) {
+        return true;
+    }
+    node.hasLoadable = false;
+    for (auto& child : node.children) {
+        node.hasLoadable |= sortAndMark(child);
+    }
+    std::sort(node.children.begin(), node.children.end(), nodeSort);
+    return node.hasLoadable;
+}
+
+bool isListed(const ScanNode& node) {
+    return !isFolderKind(node.kind) || node.hasLoadable;
+}
+
+// Index file: header, then the scan tree in preorder. Each node is its kind
+// (u8), name length (u16) and name; folders add their modification time
+// (u64) and child count (u32). Integers are little-endian.
+constexpr char kIndexMagic[4] = {'S', 'M', 'A', 'I'};
+// Bump whenever the layout or the scanner's notion of loadable changes.
+constexpr uint16_t kIndexVersion = 1;
+
+void appendLE(std::string& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void appendNode(std::string& out, const ScanNode& node) {
+    appendLE(out, static_cast<uint8_t>(node.kind), 1);
+    appendLE(out, node.name.size(), 2);
+    out += node.name;
+    if (isFolderKind(node.kind)) {
+        appendLE(out, static_cast<uint64_t>(node.modified), 8);
+        appendLE(out, node.children.size(), 4);
+        for (const ScanNode& child : node.children) {
+            appendNode(out, child);
+        }
+    }
+}
+
+// Deepest folder nesting accepted from an index. Reading recurses per level,
+// so a damaged file must not be able to exhaust the stack.
+constexpr size_t kMaxIndexDepth = 256;
+
+class IndexReader {
+public:
+    IndexReader(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    bool readLE(uint64_t& value, size_t bytes) {
+        if (m_size - m_offset < bytes) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(m_data[m_offset + i]) << (8 * i);
+        }
+        m_offset += bytes;
+        return true;
+    }
+
+    bool readString(std::string& value, size_t length) {
+        if (m_size - m_offset < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+
+    bool readNode(ScanNode& node, size_t depth = 0) {
+        if (depth > kMaxIndexDepth) {
+            return false;
+        }
+        uint64_t kind = 0;
+        uint64_t nameLength = 0;
+        if (!readLE(kind, 1) || kind > static_cast<uint64_t>(AssetKind::ModelBundle) ||
+            !readLE(nameLength, 2) || !readString(node.name, nameLength)) {
+            return false;
+        }
+        node.kind = static_cast<AssetKind>(kind);
+        if (!isFolderKind(node.kind)) {
+            return isLoadable(node.kind);
+        }
+        uint64_t modified = 0;
+        uint64_t childCount = 0;
+        if (!readLE(modified, 8) || !readLE(childCount, 4) || childCount > m_size - m_offset) {
+            return false;
+        }
+        node.modified = static_cast<int64_t>(modified);
+        node.children.resize(childCount);
+        for (ScanNode& child : node.children) {
+            if (!readNode(child, depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool atEnd() const { return m_offset == m_size; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+};
+
+std::string indexRootKey(const std::filesystem::path& rootPath) {
+    std::error_code ec;
+    const std::filesystem::path absolute = std::filesystem::absolute(rootPath, ec);
+    return (ec ? rootPath : absolute).lexically_normal().generic_string();
+}
+
+bool loadIndex(const std::filesystem::path& indexPath, const std::string& rootKey, ScanNode& root) {
+    std::string error;
+    auto file = MappedFile::open(indexPath, error);
+    if (!file) {
+        return false;
+    }
+    IndexReader reader(file->data(), file->size());
+    std::string magic;
+    uint64_t version = 0;
+    uint64_t rootLength = 0;
+    std::string storedRoot;
+    if (!reader.readString(magic, sizeof(kIndexMagic)) ||
+        std::memcmp(magic.data(), kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+        !reader.readLE(version, 2) || version != kIndexVersion ||
+        !reader.readLE(rootLength, 4) || !reader.readString(storedRoot, rootLength) || storedRoot != rootKey) {
+        return false;
+    }
+    if (!reader.readNode(root) || !isFolderKind(root.kind) || !reader.atEnd()) {
+        SMSTRIKERS_LOG_WARN("Ignoring damaged asset index: " << indexPath.string());
+        root = {};
+        return false;
+    }
+    return true;
+}
+
+void saveIndex(const std::filesystem::path& indexPath, const std::string& rootKey, const ScanNode& root) {
+    std::string out(kIndexMagic, sizeof(kIndexMagic));
+    appendLE(out, kIndexVersion, 2);
+    appendLE(out, rootKey.size(), 4);
+    out += rootKey;
+    appendNode(out, root);
+
+    // Write under a temporary name and rename, so a crash never leaves a
+    // truncated index behind.
+    std::filesystem::path tempPath = indexPath;
+    tempPath += ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!stream) {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            SMSTRIKERS_LOG_WARN("Could not write asset index: " << tempPath.string());
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, indexPath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        SMSTRIKERS_LOG_WARN("Could not write asset index: " << indexPath.string());
+    }
+}
+
+// Strings are packed into blocks of this size; longer paths get their own.
+constexpr size_t kStringBlockSize = 64 * 1024;
+
+// Edits leave dead slots behind; the array is rebuilt once there are more of
+// those than live nodes, and at least this many.
+constexpr size_t kCompactThreshold = 1024;
+
+// Same order as nodeSort, against a node that is not in the array yet.
+bool sortsBefore(const AssetNode& node, AssetKind kind, std::string_view name) {
+    if (isFolderKind(node.kind) != isFolderKind(kind)) {
+        return isFolderKind(node.kind);
+    }
+    return node.name < name;
+}
+
+// Breadth first, so every directory follows its parent.
+void collectDirectories(const ScanNode& root, std::vector<ScannedDirectory>& directories) {
+    directories.clear();
+    std::vector<const ScanNode*> sources = {&root};
+    directories.emplace_back();
+    directories.back().modified = root.modified;
+    for (size_t index = 0; index < sources.size(); ++index) {
+        const ScanNode& source = *sources[index];
+        const std::string parentPath = directories[index].relativePath;
+        directories[index].entries.reserve(source.children.size());
+        for (const ScanNode& child : source.children) {
+            directories[index].entries.push_back(child.name);
         }
-        if (!node.children.empty()) {
-            const AssetNode* found = findNodeRecursive(node.children, relativePath);
-            if (found) {
-                return found;
+        for (const ScanNode& child : source.children) {
+            if (!isFolderKind(child.kind)) {
+                continue;
             }
+            ScannedDirectory directory;
+            directory.relativePath = parentPath.empty() ? child.name : parentPath + "/" + child.name;
+            directory.modified = child.modified;
+            directories.push_back(std::move(directory));
+            sources.push_back(&child);
         }
     }
-    return nullptr;
 }
 
 } // namespace
 
-bool AssetTreeModel::loadFromFilesystem(const std::string& rootPath) {
-    m_roots.clear();
+bool AssetTreeModel::loadFromFilesystem(const std::string& rootPath, const std::filesystem::path& indexPath,
+                                        bool reuseIndex, std::vector<ScannedDirectory>* directories) {
+    m_nodes.clear();
+    m_pathIndex.clear();
+    m_nameIndex.clear();
+    m_nameIndexDirty = true;
+    m_deadNodes = 0;
+    m_stringBlocks.clear();
+    m_stringBlockUsed = 0;
+    m_stringBlockSize = 0;
     m_stats = {};
+    m_revision++;
     m_rootPathString = rootPath;
     m_rootPath = std::filesystem::path(rootPath);
 
     if (rootPath.empty()) {
-        std::cout << "Assets root is empty." << std::endl;
+        SMSTRIKERS_LOG_INFO("Assets root is empty.");
         return false;
     }
 
     if (!std::filesystem::exists(m_rootPath) || !std::filesystem::is_directory(m_rootPath)) {
-        std::cout << "Assets root not found: " << rootPath << std::endl;
+        SMSTRIKERS_LOG_INFO("Assets root not found: " << rootPath);
         return false;
     }
 
-    try {
-        for (const auto& entry : std::filesystem::directory_iterator(m_rootPath)) {
-            if (entry.is_directory()) {
-                AssetNode node = buildNode(entry);
-                if (!node.children.empty()) {
-                    m_roots.push_back(std::move(node));
-                }
-                continue;
-            }
+    auto start = std::chrono::steady_clock::now();
+    const std::string rootKey = indexPath.empty() ? std::string() : indexRootKey(m_rootPath);
+    ScanNode cachedRoot;
+    const bool haveIndex = !indexPath.empty() && reuseIndex && loadIndex(indexPath, rootKey, cachedRoot);
 
-            if (entry.is_regular_file()) {
-                std::string ext = toLower(entry.path().extension().string());
-                AssetKind kind = assetKindFromExtension(ext);
-                if (!isLoadable(kind)) {
-                    continue;
-                }
-                m_roots.push_back(buildNode(entry));
+    ScanNode scanRoot;
+    scanRoot.kind = AssetKind::Folder;
+    ScanResult scanResult;
+    std::string error;
+    if (!scanDirectoryTree(m_rootPath, haveIndex ? &cachedRoot : nullptr, scanRoot, scanResult, error)) {
+        SMSTRIKERS_LOG_ERROR("Error scanning assets root: " << error);
+        return false;
+    }
+    sortAndMark(scanRoot);
+    if (!indexPath.empty() && (!haveIndex || scanResult.listed > 0)) {
+        saveIndex(indexPath, rootKey, scanRoot);
+    }
+    if (directories) {
+        collectDirectories(scanRoot, *directories);
+    }
+
+    // Flatten breadth first, so every node's children end up next to each other.
+    AssetNode rootNode;
+    rootNode.kind = AssetKind::Folder;
+    m_nodes.push_back(rootNode);
+    std::vector<const ScanNode*> sources = {&scanRoot};
+    for (size_t index = 0; index < m_nodes.size(); ++index) {
+        const ScanNode& source = *sources[index];
+        const std::string_view parentPath = m_nodes[index].relativePath;
+        m_nodes[index].firstChild = static_cast<AssetNodeIndex>(m_nodes.size());
+        m_nodes[index].childCount = static_cast<uint32_t>(
+            std::count_if(source.children.begin(), source.children.end(), isListed));
+        for (const ScanNode& child : source.children) {
+            if (!isListed(child)) {
                 continue;
             }
+            AssetNode node;
+            node.kind = child.kind;
+            node.parent = static_cast<AssetNodeIndex>(index);
+            node.relativePath = internPath(parentPath, child.name);
+            node.name = node.relativePath.substr(node.relativePath.size() - child.name.size());
+            m_pathIndex.emplace(node.relativePath, static_cast<AssetNodeIndex>(m_nodes.size()));
+            m_nodes.push_back(node);
+            sources.push_back(&child);
         }
-        std::sort(m_roots.begin(), m_roots.end(), nodeSort);
+    }
 
-        for (const auto& node : m_roots) {
-            accumulateStats(node);
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Error scanning assets root: " << e.what() << std::endl;
+    for (size_t index = 1; index < m_nodes.size(); ++index) {
+        countNode(m_nodes[index].kind, true);
+    }
+    const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    SMSTRIKERS_LOG_DEBUG("Scanned " << m_stats.nodeCount << " asset nodes in " << elapsedMs << " ms ("
+                         << scanResult.listed << " directories listed, " << scanResult.reused << " from index)");
+
+    return true;
+}
+
+AssetNodeIndex AssetTreeModel::findByPath(std::string_view relativePath) const {
+    if (relativePath.empty()) {
+        return kInvalidAssetNode;
+    }
+    auto it = m_pathIndex.find(relativePath);
+    return it != m_pathIndex.end() ? it->second : kInvalidAssetNode;
+}
+
+AssetNodeIndex AssetTreeModel::findByName(std::string_view name) const {
+    if (m_nameIndexDirty) {
+        rebuildNameIndex();
+    }
+    auto it = m_nameIndex.find(name);
+    return it != m_nameIndex.end() ? it->second : kInvalidAssetNode;
+}
+
+std::string_view AssetTreeModel::internPath(std::string_view parentPath, std::string_view name) {
+    const size_t length = parentPath.empty() ? name.size() : parentPath.size() + 1 + name.size();
+    if (m_stringBlockUsed + length + 1 > m_stringBlockSize) {
+        m_stringBlockSize = std::max(kStringBlockSize, length + 1);
+        m_stringBlocks.push_back(std::make_unique<char[]>(m_stringBlockSize));
+        m_stringBlockUsed = 0;
+    }
+    char* out = m_stringBlocks.back().get() + m_stringBlockUsed;
+    char* cursor = out;
+    if (!parentPath.empty()) {
+        cursor = std::copy(parentPath.begin(), parentPath.end(), cursor);
+        *cursor++ = '/';
+    }
+    cursor = std::copy(name.begin(), name.end(), cursor);
+    *cursor = '\0';
+    m_stringBlockUsed += length + 1;
+    return std::string_view(out, length);
+}
+
+bool AssetTreeModel::addFile(std::string_view relativePath) {
+    if (m_nodes.empty() || relativePath.empty() || findByPath(relativePath) != kInvalidAssetNode) {
+        return false;
+    }
+    const size_t nameStart = relativePath.rfind('/') + 1; // npos + 1 == 0
+    const std::string_view name = relativePath.substr(nameStart);
+    const AssetKind kind = assetKindFromFileName(name);
+    if (!isLoadable(kind) || name.empty()) {
         return false;
     }
 
+    // Folders without loadable files are not in the tree; add the missing ones.
+    AssetNodeIndex parent = kRootIndex;
+    for (size_t start = 0; start < nameStart;) {
+        const size_t end = relativePath.find('/', start);
+        AssetNodeIndex folder = findByPath(relativePath.substr(0, end));
+        if (folder == kInvalidAssetNode) {
+            folder = insertChild(parent, relativePath.substr(start, end - start), AssetKind::Folder);
+        } else if (m_nodes[folder].kind != AssetKind::Folder) {
+            return false;
+        }
+        parent = folder;
+        start = end + 1;
+    }
+    insertChild(parent, name, kind);
+    m_nameIndexDirty = true;
+    m_revision++;
     return true;
 }
 
-AssetNode AssetTreeModel::buildNode(const std::filesystem::directory_entry& entry) {
-    AssetNode node;
-    node.name = entry.path().filename().string();
-
-    if (entry.is_directory()) {
-        node.kind = AssetKind::Folder;
-        node.relativePath = std::filesystem::relative(entry.path(), m_rootPath).generic_string();
-        buildChildren(entry.path(), node.children);
-    } else if (entry.is_regular_file()) {
-        std::string ext = toLower(entry.path().extension().string());
-        node.kind = assetKindFromExtension(ext);
-        node.relativePath = std::filesystem::relative(entry.path(), m_rootPath).generic_string();
-    } else {
-        node.kind = AssetKind::File;
-        node.relativePath = std::filesystem::relative(entry.path(), m_rootPath).generic_string();
-    }
-
-    return node;
-}
-
-void AssetTreeModel::buildChildren(const std::filesystem::path& dirPath, std::vector<AssetNode>& outChildren) {
-    for (const auto& entry : std::filesystem::directory_iterator(dirPath)) {
-        if (entry.is_directory()) {
-            AssetNode child = buildNode(entry);
-            if (!child.children.empty()) {
-                outChildren.push_back(std::move(child));
-            }
-            continue;
+bool AssetTreeModel::remove(std::string_view relativePath) {
+    AssetNodeIndex index = findByPath(relativePath);
+    if (index == kInvalidAssetNode) {
+        return false;
+    }
+
+    for (;;) {
+        const AssetNodeIndex parentIndex = m_nodes[index].parent;
+        releaseSubtree(index);
+
+        // Close the gap so the parent's children stay contiguous.
+        AssetNode& parent = m_nodes[parentIndex];
+        const AssetNodeIndex end = parent.firstChild + parent.childCount;
+        parent.childCount--;
+        for (AssetNodeIndex next = index + 1; next < end; ++next) {
+            moveNode(next, next - 1);
         }
+        m_nodes[end - 1] = AssetNode();
+        m_deadNodes++;
 
-        if (entry.is_regular_file()) {
-            std::string ext = toLower(entry.path().extension().string());
-            AssetKind kind = assetKindFromExtension(ext);
-            if (!isLoadable(kind)) {
-                continue;
-            }
-            AssetNode child = buildNode(entry);
-            outChildren.push_back(std::move(child));
-            continue;
+        if (parentIndex == kRootIndex || m_nodes[parentIndex].childCount > 0) {
+            break;
         }
+        index = parentIndex;
+    }
+
+    m_nameIndexDirty = true;
+    m_revision++;
+    if (m_deadNodes >= kCompactThreshold && m_deadNodes > m_nodes.size() - m_deadNodes) {
+        compact();
     }
-    std::sort(outChildren.begin(), outChildren.end(), nodeSort);
+    return true;
 }
 
-void AssetTreeModel::accumulateStats(const AssetNode& node) {
-    m_stats.nodeCount++;
-    if (node.kind == AssetKind::Folder) {
-        m_stats.folderCount++;
-    } else {
-        m_stats.fileCount++;
+AssetNodeIndex AssetTreeModel::insertChild(AssetNodeIndex parentIndex, std::string_view name, AssetKind kind) {
+    AssetNodeIndex first = m_nodes[parentIndex].firstChild;
+    const uint32_t count = m_nodes[parentIndex].childCount;
+
+    // Only a range at the end of the array can grow; move it there first.
+    if (first + count != m_nodes.size()) {
+        const AssetNodeIndex newFirst = static_cast<AssetNodeIndex>(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + count);
+        for (uint32_t i = 0; i < count; ++i) {
+            moveNode(first + i, newFirst + i);
+            m_nodes[first + i] = AssetNode();
+        }
+        m_deadNodes += count;
+        first = newFirst;
+        m_nodes[parentIndex].firstChild = first;
     }
-    if (isLoadable(node.kind)) {
-        m_stats.loadableCount++;
+
+    auto begin = m_nodes.begin() + first;
+    auto position = std::partition_point(begin, begin + count, [&](const AssetNode& node) {
+        return sortsBefore(node, kind, name);
+    });
+    const AssetNodeIndex index = static_cast<AssetNodeIndex>(position - m_nodes.begin());
+    m_nodes.emplace_back();
+    for (AssetNodeIndex slot = first + count; slot > index; --slot) {
+        moveNode(slot - 1, slot);
     }
-    for (const auto& child : node.children) {
-        accumulateStats(child);
+
+    AssetNode node;
+    node.kind = kind;
+    node.parent = parentIndex;
+    node.relativePath = internPath(m_nodes[parentIndex].relativePath, name);
+    node.name = node.relativePath.substr(node.relativePath.size() - name.size());
+    node.firstChild = static_cast<AssetNodeIndex>(m_nodes.size());
+    m_nodes[index] = node;
+    m_pathIndex[node.relativePath] = index;
+    m_nodes[parentIndex].childCount++;
+    countNode(kind, true);
+    return index;
+}
+
+void AssetTreeModel::moveNode(AssetNodeIndex from, AssetNodeIndex to) {
+    const AssetNode& node = m_nodes[to] = m_nodes[from];
+    for (uint32_t i = 0; i < node.childCount; ++i) {
+        m_nodes[node.firstChild + i].parent = to;
     }
+    m_pathIndex[node.relativePath] = to;
 }
 
-const AssetNode* AssetTreeModel::findByPath(const std::string& relativePath) const {
-    if (relativePath.empty()) {
-        return nullptr;
+// Drops a node and its descendants from the indices and stats, and frees the
+// descendants' slots. The node's own slot is left to the caller.
+void AssetTreeModel::releaseSubtree(AssetNodeIndex index) {
+    std::vector<AssetNodeIndex> stack = {index};
+    while (!stack.empty()) {
+        const AssetNodeIndex current = stack.back();
+        stack.pop_back();
+        const AssetNode& node = m_nodes[current];
+        for (uint32_t i = 0; i < node.childCount; ++i) {
+            stack.push_back(node.firstChild + i);
+        }
+        m_pathIndex.erase(node.relativePath);
+        countNode(node.kind, false);
+        if (current != index) {
+            m_nodes[current] = AssetNode();
+            m_deadNodes++;
+        }
+    }
+}
+
+void AssetTreeModel::countNode(AssetKind kind, bool added) {
+    auto update = [added](size_t& counter) {
+        if (added) {
+            counter++;
+        } else {
+            counter--;
+        }
+    };
+    update(m_stats.nodeCount);
+    update(kind == AssetKind::Folder ? m_stats.folderCount : m_stats.fileCount);
+    if (isLoadable(kind)) {
+        update(m_stats.loadableCount);
     }
-    return findNodeRecursive(m_roots, relativePath);
+}
+
+// Re-flattens the live nodes breadth first into fresh arrays and strings.
+void AssetTreeModel::compact() {
+    std::vector<AssetNode> oldNodes = std::move(m_nodes);
+    std::vector<std::unique_ptr<char[]>> oldBlocks = std::move(m_stringBlocks);
+    m_nodes.clear();
+    m_nodes.reserve(oldNodes.size() - m_deadNodes);
+    m_stringBlocks.clear();
+    m_stringBlockUsed = 0;
+    m_stringBlockSize = 0;
+    m_pathIndex.clear();
+
+    m_nodes.push_back(oldNodes[kRootIndex]);
+    std::vector<AssetNodeIndex> sources = {kRootIndex};
+    for (size_t index = 0; index < m_nodes.size(); ++index) {
+        const AssetNode& source = oldNodes[sources[index]];
+        const std::string_view parentPath = m_nodes[index].relativePath;
+        m_nodes[index].firstChild = static_cast<AssetNodeIndex>(m_nodes.size());
+        for (uint32_t i = 0; i < source.childCount; ++i) {
+            AssetNode node = oldNodes[source.firstChild + i];
+            node.parent = static_cast<AssetNodeIndex>(index);
+            node.relativePath = internPath(parentPath, node.name);
+            node.name = node.relativePath.substr(node.relativePath.size() - node.name.size());
+            m_pathIndex.emplace(node.relativePath, static_cast<AssetNodeIndex>(m_nodes.size()));
+            m_nodes.push_back(node);
+            sources.push_back(source.firstChild + i);
+        }
+    }
+    m_deadNodes = 0;
+    m_nameIndexDirty = true;
+}
+
+void AssetTreeModel::rebuildNameIndex() const {
+    // Names repeat across folders; the first one in depth-first order wins.
+    m_nameIndex.clear();
+    std::vector<AssetNodeIndex> stack;
+    if (const AssetNode* rootNode = root()) {
+        for (uint32_t i = rootNode->childCount; i > 0; --i) {
+            stack.push_back(rootNode->firstChild + i - 1);
+        }
+    }
+    while (!stack.empty()) {
+        const AssetNodeIndex index = stack.back();
+        stack.pop_back();
+        const AssetNode& node = m_nodes[index];
+        m_nameIndex.emplace(node.name, index);
+        for (uint32_t i = node.childCount; i > 0; --i) {
+            stack.push_back(node.firstChild + i - 1);
+        }
+    }
+    m_nameIndexDirty = false;
 }
 
 bool isLoadable(AssetKind kind) {
@@ -189,6 +833,14 @@ const char* assetKindShortLabel(AssetKind kind) {
     }
 }
 
+AssetKind assetKindFromFileName(std::string_view fileName) {
+    const size_t dot = fileName.rfind('.');
+    if (dot == std::string_view::npos || dot == 0) {
+        return AssetKind::File;
+    }
+    return assetKindFromExtension(toLower(std::string(fileName.substr(dot))));
+}
+
 AssetKind assetKindFromExtension(const std::string& extension) {
     if (extension == ".glt") {
         return AssetKind::TextureBundle;
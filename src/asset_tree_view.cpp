@@ -1,46 +1,139 @@
 #include "asset_tree_view.h"
+#include <functional>
 #include <imgui.h>
 
 namespace SMStrikers {
 
-void AssetTreeView::renderTree(const std::vector<AssetNode>& roots, std::string& selectedPath) {
-    for (const auto& node : roots) {
-        renderTreeNode(node, selectedPath);
+namespace {
+
+const char* kindIcon(AssetKind kind) {
+    switch (kind) {
+    case AssetKind::Folder:
+        return "[D]";
+    case AssetKind::ModelBundle:
+        return "[M]";
+    case AssetKind::TextureBundle:
+        return "[T]";
+    default:
+        return "[F]";
     }
 }
 
-void AssetTreeView::renderTreeNode(const AssetNode& node, std::string& selectedPath) {
-    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick;
+} // namespace
 
-    if (node.children.empty()) {
-        flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+void AssetTreeView::renderTree(const AssetTreeModel& model, AssetNodeIndex& selectedIndex) {
+    const AssetNode* root = model.root();
+    if (!root) {
+        return;
+    }
+    if (&model != m_model || model.revision() != m_revision) {
+        rebuildEntries(model);
     }
+    if (m_rowsDirty) {
+        rebuildRows(model);
+    }
+
+    // Rows are drawn without TreePush, so indent them by hand.
+    const float startX = ImGui::GetCursorPosX();
+    const float indent = ImGui::GetStyle().IndentSpacing;
+    bool toggled = false;
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(m_rows.size()));
+    while (clipper.Step()) {
+        for (int rowIndex = clipper.DisplayStart; rowIndex < clipper.DisplayEnd; ++rowIndex) {
+            const Row& row = m_rows[rowIndex];
+            const AssetNode& node = *model.node(row.index);
+            NodeEntry& entry = m_entries[row.index];
 
-    if (node.relativePath == selectedPath) {
-        flags |= ImGuiTreeNodeFlags_Selected;
+            ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick |
+                                       ImGuiTreeNodeFlags_NoTreePushOnOpen;
+            if (node.childCount == 0) {
+                flags |= ImGuiTreeNodeFlags_Leaf;
+            }
+            if (row.index == selectedIndex) {
+                flags |= ImGuiTreeNodeFlags_Selected;
+            }
+
+            ImGui::SetCursorPosX(startX + static_cast<float>(row.depth) * indent);
+            if (node.childCount > 0) {
+                ImGui::SetNextItemOpen(entry.expanded);
+            }
+            const bool open = ImGui::TreeNodeEx(reinterpret_cast<const void*>(entry.id), flags, "%s",
+                                                m_labels.data() + entry.labelOffset);
+
+            if (ImGui::IsItemClicked()) {
+                selectedIndex = row.index;
+            }
+
+            if (node.childCount > 0 && open != entry.expanded) {
+                entry.expanded = open;
+                if (open) {
+                    m_expandedPaths.emplace(node.relativePath);
+                } else {
+                    m_expandedPaths.erase(std::string(node.relativePath));
+                }
+                toggled = true;
+            }
+        }
     }
+    clipper.End();
 
-    const char* icon = "[F]";
-    if (node.kind == AssetKind::Folder) {
-        icon = "[D]";
-    } else if (node.kind == AssetKind::ModelBundle) {
-        icon = "[M]";
-    } else if (node.kind == AssetKind::TextureBundle) {
-        icon = "[T]";
+    if (toggled) {
+        m_rowsDirty = true;
     }
+}
+
+void AssetTreeView::rebuildEntries(const AssetTreeModel& model) {
+    m_model = &model;
+    m_revision = model.revision();
+    m_entries.clear();
+    m_labels.clear();
 
-    std::string label = std::string(icon) + " " + node.name + "##" + node.relativePath;
-    bool open = ImGui::TreeNodeEx(label.c_str(), flags);
+    // Dead slots left by edits are never reached from the root; they keep
+    // default entries.
+    std::vector<AssetNodeIndex> pending = {AssetTreeModel::kRootIndex};
+    while (!pending.empty()) {
+        const AssetNode& parent = *model.node(pending.back());
+        pending.pop_back();
+        for (uint32_t i = 0; i < parent.childCount; ++i) {
+            const AssetNodeIndex index = parent.firstChild + i;
+            const AssetNode& node = *model.node(index);
+            if (m_entries.size() <= index) {
+                m_entries.resize(index + 1);
+            }
+            NodeEntry& entry = m_entries[index];
+            entry.labelOffset = static_cast<uint32_t>(m_labels.size());
+            m_labels.append(kindIcon(node.kind)).append(" ").append(node.name).push_back('\0');
+            entry.id = static_cast<uintptr_t>(std::hash<std::string_view>{}(node.relativePath));
+            if (node.childCount > 0) {
+                pending.push_back(index);
+            }
+        }
+    }
 
-    if (ImGui::IsItemClicked()) {
-        selectedPath = node.relativePath;
+    for (const std::string& path : m_expandedPaths) {
+        const AssetNodeIndex index = model.findByPath(path);
+        if (index < m_entries.size()) {
+            m_entries[index].expanded = true;
+        }
     }
+    m_rowsDirty = true;
+}
+
+void AssetTreeView::rebuildRows(const AssetTreeModel& model) {
+    m_rows.clear();
+    appendRows(model, *model.root(), 0);
+    m_rowsDirty = false;
+}
 
-    if (open && !node.children.empty()) {
-        for (const auto& child : node.children) {
-            renderTreeNode(child, selectedPath);
+void AssetTreeView::appendRows(const AssetTreeModel& model, const AssetNode& parent, uint32_t depth) {
+    for (uint32_t i = 0; i < parent.childCount; ++i) {
+        const AssetNodeIndex index = parent.firstChild + i;
+        m_rows.push_back({index, depth});
+        const AssetNode& node = *model.node(index);
+        if (node.childCount > 0 && m_entries[index].expanded) {
+            appendRows(model, node, depth + 1);
         }
-        ImGui::TreePop();
     }
 }
 
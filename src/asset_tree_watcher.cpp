@@ -0,0 +1,297 @@
+#include "asset_tree_watcher.h"
+#include "log.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace SMStrikers {
+
+AssetTreeWatcher::~AssetTreeWatcher() {
+    stop();
+}
+
+void AssetTreeWatcher::takeChanges(std::vector<AssetTreeChange>& changes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_changes.empty()) {
+        return;
+    }
+    changes.insert(changes.end(), std::make_move_iterator(m_changes.begin()), std::make_move_iterator(m_changes.end()));
+    m_changes.clear();
+}
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t kWatchMask =
+    IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+} // namespace
+
+bool AssetTreeWatcher::start(const std::filesystem::path& rootPath, std::vector<ScannedDirectory> directories) {
+    stop();
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_inotifyFd < 0 || m_wakeFd < 0) {
+        SMSTRIKERS_LOG_WARN("Asset watcher unavailable: " << std::strerror(errno));
+        stop();
+        return false;
+    }
+    m_rootPath = rootPath;
+
+    // Only the root is watched here, so a failure can be reported; the scanned
+    // directories are watched by the thread.
+    if (addWatch("") < 0) {
+        SMSTRIKERS_LOG_WARN("Cannot watch asset root: " << rootPath.string());
+        stop();
+        return false;
+    }
+    m_stopRequested.store(false);
+    m_thread = std::thread(&AssetTreeWatcher::run, this, std::move(directories));
+    return true;
+}
+
+void AssetTreeWatcher::stop() {
+    if (m_thread.joinable()) {
+        m_stopRequested.store(true);
+        const uint64_t wake = 1;
+        if (write(m_wakeFd, &wake, sizeof(wake)) < 0) {
+            SMSTRIKERS_LOG_WARN("Failed to wake asset watcher: " << std::strerror(errno));
+        }
+        m_thread.join();
+    }
+    if (m_inotifyFd >= 0) {
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+    m_watches.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_changes.clear();
+}
+
+void AssetTreeWatcher::run(std::vector<ScannedDirectory> directories) {
+    std::vector<AssetTreeChange> changes;
+    watchScanned(directories, changes);
+    directories = {};
+    publish(changes);
+    SMSTRIKERS_LOG_DEBUG("Watching " << m_watches.size() << " asset directories");
+
+    alignas(inotify_event) char buffer[64 * 1024];
+    pollfd fds[2] = {{m_inotifyFd, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SMSTRIKERS_LOG_WARN("Asset watcher stopped: " << std::strerror(errno));
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+
+        ssize_t size = 0;
+        while ((size = read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+            handleEvents(buffer, static_cast<size_t>(size), changes);
+        }
+        publish(changes);
+    }
+}
+
+void AssetTreeWatcher::publish(std::vector<AssetTreeChange>& changes) {
+    if (changes.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_changes.insert(m_changes.end(), std::make_move_iterator(changes.begin()),
+                     std::make_move_iterator(changes.end()));
+    changes.clear();
+}
+
+void AssetTreeWatcher::handleEvents(const char* buffer, size_t size, std::vector<AssetTreeChange>& changes) {
+    for (size_t offset = 0; offset < size;) {
+        const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+        offset += sizeof(inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            changes.push_back({AssetTreeChange::Kind::Rescan, {}});
+            continue;
+        }
+        auto it = m_watches.find(event->wd);
+        if (it == m_watches.end()) {
+            continue;
+        }
+        if (event->mask & IN_IGNORED) {
+            m_watches.erase(it);
+            continue;
+        }
+        if (event->len == 0) {
+            continue;
+        }
+
+        const std::string name(event->name);
+        const std::string relativePath = it->second.empty() ? name : it->second + "/" + name;
+        const bool appeared = (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0;
+        if (event->mask & IN_ISDIR) {
+            if (appeared) {
+                // Files may already be inside, e.g. when a folder is moved in.
+                watchTree(relativePath, &changes);
+            } else {
+                unwatchTree(relativePath);
+                changes.push_back({AssetTreeChange::Kind::Removed, relativePath});
+            }
+        } else if (isLoadable(assetKindFromFileName(name))) {
+            AssetTreeChange::Kind kind = AssetTreeChange::Kind::Removed;
+            if (event->mask & IN_CLOSE_WRITE) {
+                kind = AssetTreeChange::Kind::Modified;
+            } else if (appeared) {
+                kind = AssetTreeChange::Kind::Added;
+            }
+            changes.push_back({kind, relativePath});
+        }
+    }
+}
+
+int AssetTreeWatcher::addWatch(const std::string& relativeDir) {
+    const std::filesystem::path fullPath = relativeDir.empty() ? m_rootPath : m_rootPath / relativeDir;
+    const int wd = inotify_add_watch(m_inotifyFd, fullPath.c_str(), kWatchMask);
+    if (wd < 0) {
+        const int error = errno;
+        if (error == ENOSPC) {
+            SMSTRIKERS_LOG_WARN("Out of inotify watches at " << fullPath.string()
+                                << "; raise fs.inotify.max_user_watches to follow the whole root");
+        }
+        errno = error;
+        return -1;
+    }
+    m_watches[wd] = relativeDir;
+    return wd;
+}
+
+void AssetTreeWatcher::watchScanned(const std::vector<ScannedDirectory>& directories,
+                                    std::vector<AssetTreeChange>& changes) {
+    for (const ScannedDirectory& directory : directories) {
+        if (m_stopRequested.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (addWatch(directory.relativePath) < 0) {
+            if (errno == ENOSPC) {
+                return;
+            }
+            // Gone since the scan; its parent was changed and is listed again.
+            continue;
+        }
+
+        // Watched from here on. A directory changed since the scan read it is
+        // listed again, in the same clock ticks the scan recorded.
+        const std::filesystem::path fullPath =
+            directory.relativePath.empty() ? m_rootPath : m_rootPath / directory.relativePath;
+        std::error_code ec;
+        const auto modified = std::filesystem::last_write_time(fullPath, ec);
+        if (ec || directory.modified == ScannedDirectory::kUnknownModified ||
+            static_cast<int64_t>(modified.time_since_epoch().count()) != directory.modified) {
+            relist(directory, changes);
+        }
+    }
+}
+
+void AssetTreeWatcher::relist(const ScannedDirectory& directory, std::vector<AssetTreeChange>& changes) {
+    const std::string& relativeDir = directory.relativePath;
+    auto childPath = [&](const std::string& name) {
+        return relativeDir.empty() ? name : relativeDir + "/" + name;
+    };
+
+    std::vector<std::string> missing = directory.entries;
+    std::sort(missing.begin(), missing.end());
+    std::vector<bool> found(missing.size(), false);
+
+    const std::filesystem::path fullPath = relativeDir.empty() ? m_rootPath : m_rootPath / relativeDir;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(fullPath, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        auto known = std::lower_bound(missing.begin(), missing.end(), name);
+        if (known != missing.end() && *known == name) {
+            found[static_cast<size_t>(known - missing.begin())] = true;
+            continue;
+        }
+        std::error_code typeError;
+        if (it->is_directory(typeError)) {
+            // New since the scan, so nothing below it is known either.
+            watchTree(childPath(name), &changes);
+        } else if (it->is_regular_file(typeError) && isLoadable(assetKindFromFileName(name))) {
+            changes.push_back({AssetTreeChange::Kind::Added, childPath(name)});
+        }
+    }
+    if (ec) {
+        return;
+    }
+    for (size_t index = 0; index < missing.size(); ++index) {
+        if (!found[index]) {
+            changes.push_back({AssetTreeChange::Kind::Removed, childPath(missing[index])});
+        }
+    }
+}
+
+void AssetTreeWatcher::watchTree(const std::string& relativeDir, std::vector<AssetTreeChange>* added) {
+    const std::filesystem::path fullPath = relativeDir.empty() ? m_rootPath : m_rootPath / relativeDir;
+    if (addWatch(relativeDir) < 0) {
+        return;
+    }
+
+    // Watch first, then list: anything created in between shows up twice,
+    // which the model ignores, rather than not at all.
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(fullPath, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        const std::string child = relativeDir.empty() ? name : relativeDir + "/" + name;
+        std::error_code typeError;
+        if (it->is_directory(typeError)) {
+            watchTree(child, added);
+        } else if (added && it->is_regular_file(typeError) && isLoadable(assetKindFromFileName(name))) {
+            added->push_back({AssetTreeChange::Kind::Added, child});
+        }
+    }
+}
+
+void AssetTreeWatcher::unwatchTree(const std::string& relativeDir) {
+    const std::string prefix = relativeDir + "/";
+    for (auto it = m_watches.begin(); it != m_watches.end();) {
+        if (it->second == relativeDir || it->second.compare(0, prefix.size(), prefix) == 0) {
+            inotify_rm_watch(m_inotifyFd, it->first);
+            it = m_watches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+#else
+
+bool AssetTreeWatcher::start(const std::filesystem::path& rootPath, std::vector<ScannedDirectory> directories) {
+    (void)rootPath;
+    (void)directories;
+    return false;
+}
+
+void AssetTreeWatcher::stop() {
+}
+
+void AssetTreeWatcher::run(std::vector<ScannedDirectory> directories) {
+    (void)directories;
+}
+
+#endif
+
+} // namespace SMStrikers
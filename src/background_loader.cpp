@@ -0,0 +1,242 @@
+#include "background_loader.h"
+#include "thread_pool.h"
+#include <chrono>
+
+namespace SMStrikers {
+
+namespace {
+
+// Enough for every texture of a large bundle between two frames.
+constexpr size_t kEventQueueCapacity = 1024;
+
+} // namespace
+
+BackgroundLoader::BackgroundLoader()
+    : m_events(kEventQueueCapacity)
+    , m_worker(&BackgroundLoader::workerLoop, this)
+{
+}
+
+BackgroundLoader::~BackgroundLoader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+        m_prefetchGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_condition.notify_one();
+    m_worker.join();
+}
+
+uint64_t BackgroundLoader::load(const IAssetLoader* loader, const std::filesystem::path& path,
+                                const AssetLoadOptions& options) {
+    Job job;
+    job.loader = loader;
+    job.path = path;
+    job.options = options;
+    return start(std::move(job));
+}
+
+uint64_t BackgroundLoader::decode(std::shared_ptr<TextureBundle> bundle) {
+    Job job;
+    job.bundle = std::move(bundle);
+    return start(std::move(job));
+}
+
+void BackgroundLoader::cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.reset();
+    m_jobPending.store(false, std::memory_order_relaxed);
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t BackgroundLoader::prefetch(std::vector<PrefetchRequest> requests) {
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        generation = m_prefetchGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+        m_prefetchQueue.clear();
+        for (size_t i = 0; i < requests.size(); ++i) {
+            PrefetchJob job;
+            job.generation = generation;
+            job.index = i;
+            job.request = std::move(requests[i]);
+            m_prefetchQueue.push_back(std::move(job));
+        }
+    }
+    m_condition.notify_one();
+    return generation;
+}
+
+void BackgroundLoader::cancelPrefetch() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_prefetchQueue.clear();
+    m_prefetchGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t BackgroundLoader::start(Job job) {
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        generation = m_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+        job.generation = generation;
+        m_texturesDecoded.store(0, std::memory_order_relaxed);
+        m_texturesTotal.store(0, std::memory_order_relaxed);
+        m_pending = std::make_unique<Job>(std::move(job));
+        m_jobPending.store(true, std::memory_order_relaxed);
+    }
+    m_condition.notify_one();
+    return generation;
+}
+
+void BackgroundLoader::workerLoop() {
+    for (;;) {
+        std::unique_ptr<Job> job;
+        PrefetchJob prefetchJob;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || m_pending || !m_prefetchQueue.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            if (m_pending) {
+                job = std::move(m_pending);
+                m_jobPending.store(false, std::memory_order_relaxed);
+            } else {
+                prefetchJob = std::move(m_prefetchQueue.front());
+                m_prefetchQueue.pop_front();
+            }
+        }
+
+        if (job) {
+            run(*job);
+        } else if (!runPrefetch(prefetchJob)) {
+            // Interrupted by a job; pick it up again afterwards unless the
+            // request list was replaced meanwhile.
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (prefetchJob.generation == m_prefetchGeneration.load(std::memory_order_relaxed)) {
+                m_prefetchQueue.push_front(std::move(prefetchJob));
+            }
+        }
+    }
+}
+
+void BackgroundLoader::run(Job& job) {
+    auto cancelled = [&]() {
+        return m_generation.load(std::memory_order_relaxed) != job.generation;
+    };
+
+    if (job.loader) {
+        auto result = std::make_shared<AssetLoadResult>(job.loader->load(job.path, job.options));
+        job.bundle = result->textureBundle;
+        Event loaded;
+        loaded.kind = Event::Kind::Loaded;
+        loaded.generation = job.generation;
+        loaded.result = std::move(result);
+        if (!post(std::move(loaded), m_generation)) {
+            return;
+        }
+    }
+
+    if (job.bundle) {
+        const size_t count = job.bundle->textures.size();
+        m_texturesTotal.store(count, std::memory_order_relaxed);
+        // Textures decode on the shared pool. The event queue has a single
+        // producer, so finished textures are posted one at a time.
+        std::mutex postMutex;
+        std::atomic<bool> stopped{false};
+        ThreadPool::shared().parallelFor(count, [&](size_t i) {
+            if (stopped.load(std::memory_order_relaxed) || cancelled()) {
+                return;
+            }
+            job.bundle->textures[i].pixels();
+            job.bundle->textures[i].thumbnailPixels();
+
+            std::lock_guard<std::mutex> lock(postMutex);
+            // A newer job may have reset the progress counters during the decode.
+            if (cancelled()) {
+                return;
+            }
+            m_texturesDecoded.fetch_add(1, std::memory_order_relaxed);
+            Event decoded;
+            decoded.kind = Event::Kind::TextureDecoded;
+            decoded.generation = job.generation;
+            decoded.textureIndex = i;
+            if (!post(std::move(decoded), m_generation)) {
+                stopped.store(true, std::memory_order_relaxed);
+            }
+        });
+        if (stopped.load(std::memory_order_relaxed) || cancelled()) {
+            return;
+        }
+    }
+
+    Event finished;
+    finished.kind = Event::Kind::Finished;
+    finished.generation = job.generation;
+    post(std::move(finished), m_generation);
+}
+
+bool BackgroundLoader::runPrefetch(PrefetchJob& job) {
+    auto interrupted = [&]() {
+        return m_jobPending.load(std::memory_order_relaxed) ||
+               m_prefetchGeneration.load(std::memory_order_relaxed) != job.generation;
+    };
+    if (interrupted()) {
+        return false;
+    }
+
+    const PrefetchRequest& request = job.request;
+    if (!job.result) {
+        // The loader starts reading the whole file ahead on its own mapping,
+        // before the dictionary parse touches the first pages.
+        AssetLoadOptions options = request.options;
+        options.readAhead = true;
+        job.result = std::make_shared<AssetLoadResult>(request.loader->load(request.path, options));
+
+        size_t decodedBytes = 0;
+        if (job.result->textureBundle) {
+            for (const auto& image : job.result->textureBundle->textures) {
+                decodedBytes += static_cast<size_t>(image.width) * image.height * 4;
+            }
+        }
+        job.decode = job.result->textureBundle && decodedBytes <= request.decodeBudgetBytes;
+    }
+
+    if (job.decode) {
+        auto& textures = job.result->textureBundle->textures;
+        for (; job.nextTexture < textures.size(); ++job.nextTexture) {
+            if (interrupted()) {
+                return false;
+            }
+            textures[job.nextTexture].pixels();
+            textures[job.nextTexture].thumbnailPixels();
+        }
+    }
+
+    Event prefetched;
+    prefetched.kind = Event::Kind::Prefetched;
+    prefetched.generation = job.generation;
+    prefetched.textureIndex = job.index;
+    prefetched.result = std::move(job.result);
+    post(std::move(prefetched), m_prefetchGeneration);
+    return true;
+}
+
+bool BackgroundLoader::post(Event event, const std::atomic<uint64_t>& generation) {
+    const uint64_t tag = event.generation;
+    auto stale = [&]() {
+        return generation.load(std::memory_order_relaxed) != tag;
+    };
+    // The render thread drains the queue every frame; wait for room unless
+    // the work has been superseded in the meantime.
+    while (!m_events.tryPush(event)) {
+        if (stale()) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return !stale();
+}
+
+} // namespace SMStrikers
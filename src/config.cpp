@@ -1,5 +1,5 @@
 #include "config.h"
-#include <iostream>
+#include "log.h"
 #include <sstream>
 #include <cstdlib>
 
@@ -13,10 +13,18 @@ std::string Config::getDefaultPath() {
     return ".smstrikers-viewer.conf";
 }
 
+std::string Config::getAssetIndexPath() {
+    const char* home = std::getenv("HOME");
+    if (home) {
+        return std::string(home) + "/.smstrikers-viewer.index";
+    }
+    return ".smstrikers-viewer.index";
+}
+
 bool Config::load(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cout << "Config file not found, using defaults: " << filename << std::endl;
+        SMSTRIKERS_LOG_INFO("Config file not found, using defaults: " << filename);
         return false;
     }
     
@@ -59,17 +67,35 @@ bool Config::load(const std::string& filename) {
             fontPixelSnapH = (value == "true" || value == "1");
         } else if (key == "assetsRoot") {
             assetsRoot = value;
+        } else if (key == "watchAssetsRoot") {
+            watchAssetsRoot = (value == "true" || value == "1");
+        } else if (key == "textureCacheEnabled") {
+            textureCacheEnabled = (value == "true" || value == "1");
+        } else if (key == "textureCacheDir") {
+            textureCacheDir = value;
+        } else if (key == "textureCacheSizeMB") {
+            textureCacheSizeMB = std::stoi(value);
+        } else if (key == "bundleCacheCpuMB") {
+            bundleCacheCpuMB = std::stoi(value);
+        } else if (key == "bundleCacheGpuMB") {
+            bundleCacheGpuMB = std::stoi(value);
+        } else if (key == "prefetchNeighbors") {
+            prefetchNeighbors = (value == "true" || value == "1");
+        } else if (key == "textureUploadMBPerFrame") {
+            textureUploadMBPerFrame = std::stoi(value);
+        } else if (key == "texturePoolMB") {
+            texturePoolMB = std::stoi(value);
         }
     }
     
-    std::cout << "Loaded config from: " << filename << std::endl;
+    SMSTRIKERS_LOG_INFO("Loaded config from: " << filename);
     return true;
 }
 
 bool Config::save(const std::string& filename) const {
     std::ofstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "Failed to save config to: " << filename << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to save config to: " << filename);
         return false;
     }
     
@@ -89,8 +115,20 @@ bool Config::save(const std::string& filename) const {
     file << "fontPixelSnapH=" << (fontPixelSnapH ? "true" : "false") << "\n";
     file << "\n# Asset Settings\n";
     file << "assetsRoot=" << assetsRoot << "\n";
+    file << "watchAssetsRoot=" << (watchAssetsRoot ? "true" : "false") << "\n";
+    file << "\n# Texture Cache Settings\n";
+    file << "textureCacheEnabled=" << (textureCacheEnabled ? "true" : "false") << "\n";
+    file << "textureCacheDir=" << textureCacheDir << "\n";
+    file << "textureCacheSizeMB=" << textureCacheSizeMB << "\n";
+    file << "\n# Bundle Cache Settings\n";
+    file << "bundleCacheCpuMB=" << bundleCacheCpuMB << "\n";
+    file << "bundleCacheGpuMB=" << bundleCacheGpuMB << "\n";
+    file << "prefetchNeighbors=" << (prefetchNeighbors ? "true" : "false") << "\n";
+    file << "\n# Upload Settings\n";
+    file << "textureUploadMBPerFrame=" << textureUploadMBPerFrame << "\n";
+    file << "texturePoolMB=" << texturePoolMB << "\n";
     
-    std::cout << "Saved config to: " << filename << std::endl;
+    SMSTRIKERS_LOG_INFO("Saved config to: " << filename);
     return true;
 }
 
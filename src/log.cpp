@@ -0,0 +1,160 @@
+#include "log.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+namespace SMStrikers {
+
+namespace {
+
+constexpr size_t kRingCapacity = 4096;
+constexpr size_t kMaxMessageLength = 256;
+static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+// Bounded multi-producer queue: a producer claims a slot by advancing the
+// write position, fills it, then publishes it through the slot's sequence.
+struct LogSlot {
+    std::atomic<size_t> sequence{0};
+    uint16_t length = 0;
+    char text[kMaxMessageLength];
+};
+
+class LogRing {
+public:
+    LogRing() {
+        for (size_t i = 0; i < kRingCapacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~LogRing() {
+        drain();
+    }
+
+    bool push(const std::string& message) {
+        size_t position = m_writePosition.load(std::memory_order_relaxed);
+        LogSlot* slot = nullptr;
+        for (;;) {
+            slot = &m_slots[position & (kRingCapacity - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (m_writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = m_writePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        size_t length = std::min(message.size(), kMaxMessageLength);
+        std::memcpy(slot->text, message.data(), length);
+        slot->length = static_cast<uint16_t>(length);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumers serialize on a mutex; producers never touch it.
+    void drain() {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        drainLocked();
+    }
+
+    template <typename Fn>
+    void drainThen(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        drainLocked();
+        fn();
+    }
+
+    uint64_t dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    void drainLocked() {
+        bool wrote = false;
+        for (;;) {
+            LogSlot& slot = m_slots[m_readPosition & (kRingCapacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != m_readPosition + 1) {
+                break;
+            }
+            std::cout.write(slot.text, slot.length);
+            std::cout.put('\n');
+            slot.sequence.store(m_readPosition + kRingCapacity, std::memory_order_release);
+            ++m_readPosition;
+            wrote = true;
+        }
+
+        uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != m_reportedDropped) {
+            std::cout << "(" << (dropped - m_reportedDropped) << " log messages dropped)\n";
+            m_reportedDropped = dropped;
+            wrote = true;
+        }
+        if (wrote) {
+            std::cout.flush();
+        }
+    }
+
+    std::array<LogSlot, kRingCapacity> m_slots;
+    alignas(64) std::atomic<size_t> m_writePosition{0};
+    alignas(64) std::atomic<uint64_t> m_dropped{0};
+    std::mutex m_drainMutex;
+    size_t m_readPosition = 0;
+    uint64_t m_reportedDropped = 0;
+};
+
+LogRing& logRing() {
+    static LogRing ring;
+    return ring;
+}
+
+} // namespace
+
+bool Log::parseLevel(const std::string& name, LogLevel& level) {
+    static constexpr struct {
+        const char* name;
+        LogLevel level;
+    } kLevels[] = {
+        {"trace", LogLevel::Trace},
+        {"debug", LogLevel::Debug},
+        {"info", LogLevel::Info},
+        {"warn", LogLevel::Warn},
+        {"error", LogLevel::Error},
+        {"off", LogLevel::Off},
+    };
+    for (const auto& entry : kLevels) {
+        if (name == entry.name) {
+            level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Log::write(LogLevel level, const std::string& message) {
+    if (level >= LogLevel::Warn) {
+        // Keep ordering with anything still queued, then report right away.
+        logRing().drainThen([&]() {
+            std::cerr << message << std::endl;
+        });
+        return;
+    }
+    logRing().push(message);
+}
+
+void Log::flush() {
+    logRing().drain();
+}
+
+uint64_t Log::droppedCount() {
+    return logRing().dropped();
+}
+
+} // namespace SMStrikers
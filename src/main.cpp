@@ -1,4 +1,5 @@
 #include "viewer.h"
+#include "log.h"
 #include <iostream>
 #include <cstdlib>
 
@@ -30,6 +31,7 @@ void printUsage(const char* programName) {
     std::cout << "  --version, -v     Show version information" << std::endl;
     std::cout << "  --no_gui          Run without GUI (direct 3D rendering)" << std::endl;
     std::cout << "  --object <name>   Specify object to render (used with --no_gui)" << std::endl;
+    std::cout << "  --log-level <lvl> trace, debug, info (default), warn, error or off" << std::endl;
     std::cout << std::endl;
 }
 
@@ -55,6 +57,14 @@ int main(int argc, char* argv[]) {
         else if (arg == "--object" && i + 1 < argc) {
             objectName = argv[++i];
         }
+        else if (arg == "--log-level" && i + 1 < argc) {
+            SMStrikers::LogLevel level;
+            if (!SMStrikers::Log::parseLevel(argv[++i], level)) {
+                std::cerr << "Unknown log level: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+            SMStrikers::Log::setLevel(level);
+        }
     }
     
     printBanner();
@@ -0,0 +1,78 @@
+#include "mapped_file.h"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SMSTRIKERS_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SMStrikers {
+
+MappedFile::~MappedFile() {
+#ifdef SMSTRIKERS_HAS_MMAP
+    if (m_mapped) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+}
+
+void MappedFile::willNeed() const {
+#ifdef SMSTRIKERS_HAS_MMAP
+    if (m_mapped) {
+        madvise(const_cast<uint8_t*>(m_data), m_size, MADV_WILLNEED);
+    }
+#endif
+}
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::filesystem::path& path, std::string& error) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef SMSTRIKERS_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info {};
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                file->m_data = static_cast<const uint8_t*>(mapping);
+                file->m_size = static_cast<size_t>(info.st_size);
+                file->m_mapped = true;
+            }
+        }
+        ::close(fd);
+        if (file->m_mapped) {
+            return file;
+        }
+    }
+#endif
+
+    // Buffered fallback for platforms or files that cannot be mapped.
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        error = "Failed to open file";
+        return {};
+    }
+
+    stream.seekg(0, std::ios::end);
+    std::streamoff size = stream.tellg();
+    if (size <= 0) {
+        error = "Empty file";
+        return {};
+    }
+    stream.seekg(0, std::ios::beg);
+
+    file->m_buffer.resize(static_cast<size_t>(size));
+    stream.read(reinterpret_cast<char*>(file->m_buffer.data()), size);
+    if (!stream) {
+        error = "Failed to read file";
+        return {};
+    }
+    file->m_data = file->m_buffer.data();
+    file->m_size = file->m_buffer.size();
+    return file;
+}
+
+} // namespace SMStrikers
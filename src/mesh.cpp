@@ -1,5 +1,5 @@
 #include "mesh.h"
-#include <iostream>
+#include "log.h"
 #include <glm/gtc/type_ptr.hpp>
 
 namespace SMStrikers {
@@ -229,7 +229,7 @@ bool Shader::createBasicShader() {
     if (!success) {
         char infoLog[512];
         glGetProgramInfoLog(m_program, 512, nullptr, infoLog);
-        std::cerr << "ERROR: Shader program linking failed\n" << infoLog << std::endl;
+        SMSTRIKERS_LOG_ERROR("ERROR: Shader program linking failed\n" << infoLog);
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
         return false;
@@ -295,7 +295,7 @@ bool Shader::createUnlitShader() {
     if (!success) {
         char infoLog[512];
         glGetProgramInfoLog(m_program, 512, nullptr, infoLog);
-        std::cerr << "ERROR: Shader program linking failed\n" << infoLog << std::endl;
+        SMSTRIKERS_LOG_ERROR("ERROR: Shader program linking failed\n" << infoLog);
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
         return false;
@@ -319,9 +319,9 @@ GLuint Shader::compileShader(const char* source, GLenum type) {
     if (!success) {
         char infoLog[512];
         glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        std::cerr << "ERROR: Shader compilation failed (" 
-                  << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") 
-                  << ")\n" << infoLog << std::endl;
+        SMSTRIKERS_LOG_ERROR("ERROR: Shader compilation failed ("
+                             << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
+                             << ")\n" << infoLog);
         glDeleteShader(shader);
         return 0;
     }
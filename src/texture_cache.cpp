@@ -0,0 +1,332 @@
+#include "texture_cache.h"
+#include "log.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace SMStrikers {
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'M', 'T', 'C'};
+// Bump whenever decoded output changes so stale entries stop matching.
+constexpr uint16_t kFormatVersion = 1;
+constexpr const char* kEntryExtension = ".rgba";
+
+// Pixels waiting for the writer thread; stores beyond this are dropped.
+constexpr size_t kMaxQueuedBytes = 64 * 1024 * 1024;
+
+constexpr uint64_t kPrime1 = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Word-at-a-time multiplicative hash: fast enough to key multi-megabyte
+// payloads on every lookup, and well mixed enough for a cache.
+uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t seed) {
+    uint64_t hash = seed ^ (static_cast<uint64_t>(size) * kPrime1);
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + offset, sizeof(word));
+        hash = rotateLeft(hash ^ (word * kPrime2), 31) * kPrime1;
+    }
+    uint64_t tail = 0;
+    for (size_t shift = 0; offset < size; ++offset, shift += 8) {
+        tail |= static_cast<uint64_t>(data[offset]) << shift;
+    }
+    hash = rotateLeft(hash ^ (tail * kPrime2), 31) * kPrime1;
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime1;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void writeU16LE(uint8_t* dst, uint16_t value) {
+    dst[0] = static_cast<uint8_t>(value);
+    dst[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void writeU32LE(uint8_t* dst, uint32_t value) {
+    writeU16LE(dst, static_cast<uint16_t>(value));
+    writeU16LE(dst + 2, static_cast<uint16_t>(value >> 16));
+}
+
+uint16_t readU16LE(const uint8_t* src) {
+    return static_cast<uint16_t>(src[0] | (src[1] << 8));
+}
+
+uint32_t readU32LE(const uint8_t* src) {
+    return static_cast<uint32_t>(readU16LE(src)) | (static_cast<uint32_t>(readU16LE(src + 2)) << 16);
+}
+
+bool parseKey(const std::string& stem, uint64_t& key) {
+    if (stem.size() != 16) {
+        return false;
+    }
+    char* end = nullptr;
+    key = std::strtoull(stem.c_str(), &end, 16);
+    return end == stem.c_str() + stem.size();
+}
+
+} // namespace
+
+TextureCache::TextureCache(std::filesystem::path directory, uint64_t maxBytes)
+    : m_directory(std::move(directory))
+    , m_maxBytes(maxBytes)
+{
+    scanDirectory();
+    m_writer = std::thread(&TextureCache::writerLoop, this);
+}
+
+TextureCache::~TextureCache() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_writeCondition.notify_one();
+    m_writer.join();
+    writeAccessTimes();
+}
+
+std::filesystem::path TextureCache::defaultDirectory() {
+    std::filesystem::path base;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        base = xdg;
+    } else if (const char* home = std::getenv("HOME")) {
+        base = std::filesystem::path(home) / ".cache";
+    } else {
+        base = ".cache";
+    }
+    return base / "smstrikers-viewer" / "textures";
+}
+
+uint64_t TextureCache::makeKey(const uint8_t* payload, size_t payloadSize, const void* parameters,
+                               size_t parametersSize) {
+    uint64_t seed = hashBytes(static_cast<const uint8_t*>(parameters), parametersSize, kFormatVersion);
+    return hashBytes(payload, payloadSize, seed);
+}
+
+std::shared_ptr<const MappedFile> TextureCache::find(uint64_t key, uint16_t width, uint16_t height) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.find(key) == m_entries.end()) {
+            return {};
+        }
+    }
+
+    const std::filesystem::path path = entryPath(key);
+    std::string error;
+    std::shared_ptr<const MappedFile> file = MappedFile::open(path, error);
+    const size_t pixelBytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    bool valid = file && file->size() == kHeaderSize + pixelBytes &&
+                 std::memcmp(file->data(), kMagic, sizeof(kMagic)) == 0 &&
+                 readU16LE(file->data() + 4) == kFormatVersion &&
+                 readU16LE(file->data() + 8) == width && readU16LE(file->data() + 10) == height &&
+                 readU32LE(file->data() + 12) == pixelBytes;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        // Evicted while it was being opened; the mapping stays usable.
+        return valid ? file : nullptr;
+    }
+    if (!valid) {
+        SMSTRIKERS_LOG_WARN("Dropping unreadable texture cache entry: " << path.string());
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        m_totalBytes -= it->second->bytes;
+        m_lru.erase(it->second);
+        m_entries.erase(it);
+        return {};
+    }
+    touchLocked(it->second);
+    return file;
+}
+
+void TextureCache::store(uint64_t key, uint16_t width, uint16_t height, const uint8_t* rgba, size_t size) {
+    const uint64_t bytes = kHeaderSize + size;
+    if (bytes > m_maxBytes || size != static_cast<size_t>(width) * static_cast<size_t>(height) * 4) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queuedBytes + size > kMaxQueuedBytes || m_queuedKeys.count(key) != 0) {
+            return;
+        }
+        m_queuedKeys.insert(key);
+        m_queuedBytes += size;
+    }
+
+    PendingStore pending;
+    pending.key = key;
+    pending.width = width;
+    pending.height = height;
+    pending.rgba.assign(rgba, rgba + size);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writeQueue.push_back(std::move(pending));
+    }
+    m_writeCondition.notify_one();
+}
+
+void TextureCache::writerLoop() {
+    for (;;) {
+        PendingStore pending;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_writeCondition.wait(lock, [this]() { return m_stopping || !m_writeQueue.empty(); });
+            // Queued stores are finished before stopping.
+            if (m_writeQueue.empty()) {
+                return;
+            }
+            pending = std::move(m_writeQueue.front());
+            m_writeQueue.pop_front();
+        }
+
+        write(pending);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queuedKeys.erase(pending.key);
+        m_queuedBytes -= pending.rgba.size();
+    }
+}
+
+void TextureCache::write(const PendingStore& pending) {
+    const size_t size = pending.rgba.size();
+    const uint64_t bytes = kHeaderSize + size;
+
+    uint8_t header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    writeU16LE(header + 4, kFormatVersion);
+    writeU16LE(header + 8, pending.width);
+    writeU16LE(header + 10, pending.height);
+    writeU32LE(header + 12, static_cast<uint32_t>(size));
+
+    // Write under a private name and rename, so readers never map a partial entry.
+    const std::filesystem::path path = entryPath(pending.key);
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(pending.rgba.data()), static_cast<std::streamsize>(size));
+        if (!stream) {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(pending.key);
+    if (it != m_entries.end()) {
+        m_totalBytes -= it->second->bytes;
+        m_lru.erase(it->second);
+        m_entries.erase(it);
+    }
+    evictLocked(bytes);
+    m_lru.push_front({pending.key, bytes, {}, false});
+    m_entries[pending.key] = m_lru.begin();
+    m_totalBytes += bytes;
+}
+
+void TextureCache::writeAccessTimes() {
+    // Only used from the destructor, once the writer has stopped.
+    for (const Entry& entry : m_lru) {
+        if (entry.touched) {
+            std::error_code ec;
+            std::filesystem::last_write_time(entryPath(entry.key), entry.lastUse, ec);
+        }
+    }
+}
+
+uint64_t TextureCache::sizeBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totalBytes;
+}
+
+std::filesystem::path TextureCache::entryPath(uint64_t key) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return m_directory / (std::string(name) + kEntryExtension);
+}
+
+void TextureCache::scanDirectory() {
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) {
+        SMSTRIKERS_LOG_WARN("Texture cache disabled, cannot create " << m_directory.string() << ": " << ec.message());
+        m_maxBytes = 0;
+        return;
+    }
+
+    struct Found {
+        std::filesystem::file_time_type lastUse;
+        Entry entry;
+    };
+    std::vector<Found> found;
+    for (const auto& item : std::filesystem::directory_iterator(m_directory, ec)) {
+        if (!item.is_regular_file(ec)) {
+            continue;
+        }
+        const std::filesystem::path& path = item.path();
+        uint64_t key = 0;
+        if (path.extension() != kEntryExtension || !parseKey(path.stem().string(), key)) {
+            // Leftovers from an interrupted store.
+            if (path.filename().string().find(".tmp") != std::string::npos) {
+                std::filesystem::remove(path, ec);
+            }
+            continue;
+        }
+        found.push_back({item.last_write_time(ec), {key, item.file_size(ec), {}, false}});
+    }
+
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) {
+        return a.lastUse > b.lastUse;
+    });
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Found& item : found) {
+        m_lru.push_back(item.entry);
+        m_entries[item.entry.key] = std::prev(m_lru.end());
+        m_totalBytes += item.entry.bytes;
+    }
+    evictLocked(0);
+}
+
+void TextureCache::touchLocked(std::list<Entry>::iterator it) {
+    m_lru.splice(m_lru.begin(), m_lru, it);
+    it->lastUse = std::filesystem::file_time_type::clock::now();
+    it->touched = true;
+}
+
+void TextureCache::evictLocked(uint64_t incomingBytes) {
+    while (!m_lru.empty() && m_totalBytes + incomingBytes > m_maxBytes) {
+        const Entry& victim = m_lru.back();
+        std::error_code ec;
+        std::filesystem::remove(entryPath(victim.key), ec);
+        m_totalBytes -= victim.bytes;
+        m_entries.erase(victim.key);
+        m_lru.pop_back();
+    }
+}
+
+} // namespace SMStrikers
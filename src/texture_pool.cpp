@@ -0,0 +1,97 @@
+#include "texture_pool.h"
+#include <algorithm>
+
+namespace SMStrikers {
+
+namespace {
+
+// Frames a released texture waits before it can be handed out again; covers
+// the frames the driver may still have queued.
+constexpr uint64_t kHoldBackFrames = 3;
+
+// Idle textures deleted per frame at most, to spread out driver work when a
+// large bundle is dropped.
+constexpr int kDeletesPerFrame = 8;
+
+} // namespace
+
+uint64_t TexturePool::key(uint16_t width, uint16_t height, GLenum internalFormat) {
+    return (static_cast<uint64_t>(internalFormat) << 32) | (static_cast<uint64_t>(width) << 16) | height;
+}
+
+size_t TexturePool::storageBytes(const Texture& texture) {
+    // Every format pooled so far is RGBA8.
+    size_t bytes = 0;
+    for (uint32_t level = 0; level < texture.allocatedLevels; ++level) {
+        const size_t width = std::max(1, texture.width >> level);
+        const size_t height = std::max(1, texture.height >> level);
+        bytes += width * height * 4;
+    }
+    return bytes;
+}
+
+TexturePool::Texture TexturePool::acquire(uint16_t width, uint16_t height, GLenum internalFormat) {
+    auto it = m_idle.find(key(width, height, internalFormat));
+    if (it != m_idle.end()) {
+        Texture texture = it->second.texture;
+        m_pooledBytes -= storageBytes(texture);
+        m_idle.erase(it);
+        return texture;
+    }
+
+    Texture texture;
+    glGenTextures(1, &texture.id);
+    texture.width = width;
+    texture.height = height;
+    texture.internalFormat = internalFormat;
+    return texture;
+}
+
+void TexturePool::release(const Texture& texture) {
+    if (texture.id == 0) {
+        return;
+    }
+    Entry entry;
+    entry.texture = texture;
+    entry.releasedFrame = m_frame;
+    m_pooledBytes += storageBytes(texture);
+    m_heldBack.push_back(entry);
+}
+
+void TexturePool::beginFrame(size_t maxPooledBytes) {
+    ++m_frame;
+
+    // Held-back entries are in release order.
+    size_t ready = 0;
+    while (ready < m_heldBack.size() && m_frame - m_heldBack[ready].releasedFrame >= kHoldBackFrames) {
+        Entry& entry = m_heldBack[ready];
+        m_idle.emplace(key(entry.texture.width, entry.texture.height, entry.texture.internalFormat), entry);
+        ++ready;
+    }
+    m_heldBack.erase(m_heldBack.begin(), m_heldBack.begin() + static_cast<std::ptrdiff_t>(ready));
+
+    // Delete the longest idle textures first.
+    for (int deleted = 0; deleted < kDeletesPerFrame && !m_idle.empty() && m_pooledBytes > maxPooledBytes;
+         ++deleted) {
+        auto oldest = std::min_element(m_idle.begin(), m_idle.end(), [](const auto& a, const auto& b) {
+            return a.second.releasedFrame < b.second.releasedFrame;
+        });
+        m_pooledBytes -= storageBytes(oldest->second.texture);
+        glDeleteTextures(1, &oldest->second.texture.id);
+        m_idle.erase(oldest);
+    }
+}
+
+void TexturePool::clear() {
+    for (const Entry& entry : m_heldBack) {
+        glDeleteTextures(1, &entry.texture.id);
+    }
+    for (const auto& [textureKey, entry] : m_idle) {
+        glDeleteTextures(1, &entry.texture.id);
+    }
+    m_heldBack.clear();
+    m_idle.clear();
+    m_pooledBytes = 0;
+}
+
+} // namespace SMStrikers
@@ -0,0 +1,114 @@
+#include "texture_uploader.h"
+#include <algorithm>
+#include <cstring>
+
+namespace SMStrikers {
+
+namespace {
+
+// Four 4 MB buffers: a 1024x1024 level fits one, and a frame's uploads
+// rarely wait for the GPU to release a buffer from the frame before.
+constexpr size_t kBufferBytes = 4 * 1024 * 1024;
+constexpr size_t kBufferCount = 4;
+
+} // namespace
+
+void TextureUploader::beginFrame(size_t budgetBytes) {
+    m_budgetLeft = budgetBytes;
+}
+
+void TextureUploader::charge(size_t bytes) {
+    m_budgetLeft -= std::min(m_budgetLeft, bytes);
+}
+
+bool TextureUploader::acquire(Buffer& buffer) {
+    if (buffer.fence) {
+        // Never block the frame; a busy buffer ends this frame's uploads.
+        const GLenum status = glClientWaitSync(buffer.fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(buffer.fence);
+        buffer.fence = nullptr;
+    }
+    if (buffer.buffer == 0) {
+        glGenBuffers(1, &buffer.buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(kBufferBytes), nullptr, GL_STREAM_DRAW);
+    } else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.buffer);
+    }
+    return true;
+}
+
+int TextureUploader::uploadRows(GLuint texture, GLint level, int width, int height, int firstRow,
+                                const uint8_t* pixels) {
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    if (m_buffers.empty()) {
+        m_buffers.resize(kBufferCount);
+    }
+
+    GLint previousAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    int row = firstRow;
+    while (row < height && m_budgetLeft > 0) {
+        const uint8_t* source = pixels + static_cast<size_t>(row) * rowBytes;
+        if (rowBytes > kBufferBytes) {
+            // Wider than any texture this viewer loads; upload directly.
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, row, width, 1, GL_RGBA, GL_UNSIGNED_BYTE, source);
+            charge(rowBytes);
+            ++row;
+            continue;
+        }
+
+        Buffer& buffer = m_buffers[m_next];
+        if (!acquire(buffer)) {
+            break;
+        }
+        // At least one row, so a small budget still makes progress.
+        const size_t rowsByBudget = std::max<size_t>(1, m_budgetLeft / rowBytes);
+        const int rows = static_cast<int>(
+            std::min({static_cast<size_t>(height - row), kBufferBytes / rowBytes, rowsByBudget}));
+        const size_t bytes = static_cast<size_t>(rows) * rowBytes;
+
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (!mapped) {
+            break;
+        }
+        std::memcpy(mapped, source, bytes);
+        if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE) {
+            // Contents were lost (e.g. a display mode change); retry next frame.
+            break;
+        }
+        // With an unpack buffer bound, the data pointer is an offset into it.
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, row, width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_next = (m_next + 1) % m_buffers.size();
+        charge(bytes);
+        row += rows;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+    return row - firstRow;
+}
+
+void TextureUploader::clear() {
+    for (Buffer& buffer : m_buffers) {
+        if (buffer.fence) {
+            glDeleteSync(buffer.fence);
+        }
+        if (buffer.buffer != 0) {
+            glDeleteBuffers(1, &buffer.buffer);
+        }
+    }
+    m_buffers.clear();
+    m_next = 0;
+}
+
+} // namespace SMStrikers
@@ -0,0 +1,119 @@
+#include "thumbnail_atlas.h"
+#include <algorithm>
+
+namespace SMStrikers {
+
+namespace {
+
+constexpr int kPageSize = 1024;
+
+} // namespace
+
+ThumbnailAtlas::ThumbnailAtlas(int cellSize)
+    : m_cellSize(cellSize)
+    // One transparent texel between cells, so linear filtering at an image's
+    // edge never picks up its neighbour.
+    , m_cellStride(cellSize + 1)
+    , m_cellsPerRow(kPageSize / (cellSize + 1))
+{
+}
+
+int ThumbnailAtlas::add(const uint8_t* rgba, int width, int height) {
+    if (!rgba || width <= 0 || height <= 0 || width > m_cellSize || height > m_cellSize) {
+        return -1;
+    }
+
+    const int cellsPerPage = m_cellsPerRow * m_cellsPerRow;
+    auto page = std::find_if(m_pages.begin(), m_pages.end(), [](const Page& candidate) {
+        return candidate.texture != 0 && !candidate.freeCells.empty();
+    });
+    if (page == m_pages.end()) {
+        page = std::find_if(m_pages.begin(), m_pages.end(), [](const Page& candidate) {
+            return candidate.texture == 0;
+        });
+        if (page == m_pages.end()) {
+            page = m_pages.insert(m_pages.end(), Page());
+            m_slots.resize(m_pages.size() * cellsPerPage);
+        }
+        const std::vector<uint8_t> zeros(static_cast<size_t>(kPageSize) * kPageSize * 4, 0);
+        glGenTextures(1, &page->texture);
+        glBindTexture(GL_TEXTURE_2D, page->texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kPageSize, kPageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, zeros.data());
+        // Hand out low cells first; they are popped from the back.
+        page->freeCells.resize(cellsPerPage);
+        for (int cell = 0; cell < cellsPerPage; ++cell) {
+            page->freeCells[cell] = cellsPerPage - 1 - cell;
+        }
+    } else {
+        glBindTexture(GL_TEXTURE_2D, page->texture);
+    }
+
+    const int cell = page->freeCells.back();
+    page->freeCells.pop_back();
+    page->usedCells++;
+    const int x = (cell % m_cellsPerRow) * m_cellStride;
+    const int y = (cell / m_cellsPerRow) * m_cellStride;
+
+    // A reused cell still holds its previous image; clear the texels right of
+    // and below this one so the gap stays transparent.
+    const int paddedWidth = width + 1;
+    const int paddedHeight = height + 1;
+    m_staging.assign(static_cast<size_t>(paddedWidth) * paddedHeight * 4, 0);
+    for (int row = 0; row < height; ++row) {
+        std::copy_n(rgba + static_cast<size_t>(row) * width * 4, static_cast<size_t>(width) * 4,
+                    m_staging.begin() + static_cast<size_t>(row) * paddedWidth * 4);
+    }
+    GLint previousAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, m_staging.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const int handle = static_cast<int>(page - m_pages.begin()) * cellsPerPage + cell;
+    Slot& slot = m_slots[handle];
+    slot.texture = page->texture;
+    slot.u0 = static_cast<float>(x) / kPageSize;
+    slot.v0 = static_cast<float>(y) / kPageSize;
+    slot.u1 = static_cast<float>(x + width) / kPageSize;
+    slot.v1 = static_cast<float>(y + height) / kPageSize;
+    return handle;
+}
+
+void ThumbnailAtlas::remove(int handle) {
+    if (handle < 0 || handle >= static_cast<int>(m_slots.size()) || m_slots[handle].texture == 0) {
+        return;
+    }
+    const int cellsPerPage = m_cellsPerRow * m_cellsPerRow;
+    Page& page = m_pages[handle / cellsPerPage];
+    m_slots[handle] = Slot();
+    page.freeCells.push_back(handle % cellsPerPage);
+    if (--page.usedCells == 0) {
+        glDeleteTextures(1, &page.texture);
+        page = Page();
+    }
+}
+
+void ThumbnailAtlas::clear() {
+    for (Page& page : m_pages) {
+        if (page.texture != 0) {
+            glDeleteTextures(1, &page.texture);
+        }
+    }
+    m_pages.clear();
+    m_slots.clear();
+}
+
+size_t ThumbnailAtlas::gpuBytes() const {
+    size_t pages = 0;
+    for (const Page& page : m_pages) {
+        pages += page.texture != 0 ? 1 : 0;
+    }
+    return pages * kPageSize * kPageSize * 4;
+}
+
+} // namespace SMStrikers
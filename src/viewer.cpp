@@ -1,18 +1,18 @@
 #include "viewer.h"
 #include "camera.h"
+#include "log.h"
 #include "mesh.h"
+#include "texture_cache.h"
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <ImGuizmo.h>
-#include <iostream>
 #include <filesystem>
 #include <cstdio>
 #include <cfloat>
 #include <cmath>
-#include <functional>
 #include <algorithm>
 #include <vector>
 #include <glm/glm.hpp>
@@ -48,6 +48,10 @@ const char* textureFormatLabel(uint32_t format) {
     }
 }
 
+// Thumbnails this many rows beyond the visible ones keep their GL textures;
+// further away they are released and uploaded again when scrolled back.
+constexpr int kThumbnailResidentRows = 4;
+
 } // namespace
 
 Viewer::Viewer()
@@ -70,7 +74,6 @@ Viewer::Viewer()
     , m_isRotating(false)
     , m_isPanning(false)
     , m_isViewportHovered(false)
-    , m_selectedAssetPath("")
     , m_lastLoadedPath("")
     , m_lastLoadResult()
     , m_lastLoaderName("")
@@ -88,7 +91,7 @@ Viewer::~Viewer() {
 }
 
 bool Viewer::initialize(int width, int height, const std::string& title, bool noGui) {
-    std::cout << "Initializing Super Mario Strikers Viewer..." << std::endl;
+    SMSTRIKERS_LOG_INFO("Initializing Super Mario Strikers Viewer...");
     
     m_windowWidth = width;
     m_windowHeight = height;
@@ -96,18 +99,18 @@ bool Viewer::initialize(int width, int height, const std::string& title, bool no
     m_noGui = noGui;
     
     if (!initWindow()) {
-        std::cerr << "Failed to initialize window!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to initialize window!");
         return false;
     }
     
     if (!initOpenGL()) {
-        std::cerr << "Failed to initialize OpenGL!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to initialize OpenGL!");
         return false;
     }
     
     if (!m_noGui) {
         if (!initImGui()) {
-            std::cerr << "Failed to initialize ImGui!" << std::endl;
+            SMSTRIKERS_LOG_ERROR("Failed to initialize ImGui!");
             return false;
         }
     }
@@ -119,19 +122,25 @@ bool Viewer::initialize(int width, int height, const std::string& title, bool no
     m_config.load(Config::getDefaultPath());
     m_renderMode = static_cast<RenderMode>(m_config.defaultRenderMode);
     std::snprintf(m_assetsRootBuffer.data(), m_assetsRootBuffer.size(), "%s", m_config.assetsRoot.c_str());
+    if (m_config.textureCacheEnabled && m_config.textureCacheSizeMB > 0) {
+        std::filesystem::path cacheDir = m_config.textureCacheDir.empty() ? TextureCache::defaultDirectory()
+                                                                         : std::filesystem::path(m_config.textureCacheDir);
+        m_textureCache = std::make_shared<TextureCache>(
+            cacheDir, static_cast<uint64_t>(m_config.textureCacheSizeMB) * 1024 * 1024);
+    }
     
     // Create dummy mesh and shaders
     m_dummyMesh.reset(Mesh::createCube(2.0f));
     
     m_shader = std::make_unique<Shader>();
     if (!m_shader->createBasicShader()) {
-        std::cerr << "Failed to create lit shader!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to create lit shader!");
         return false;
     }
     
     m_unlitShader = std::make_unique<Shader>();
     if (!m_unlitShader->createUnlitShader()) {
-        std::cerr << "Failed to create unlit shader!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to create unlit shader!");
         return false;
     }
     
@@ -139,7 +148,7 @@ bool Viewer::initialize(int width, int height, const std::string& title, bool no
     refreshAssetTree();
     
     m_initialized = true;
-    std::cout << "Initialization complete!" << std::endl;
+    SMSTRIKERS_LOG_INFO("Initialization complete!");
     
     return m_initialized;
 }
@@ -147,7 +156,7 @@ bool Viewer::initialize(int width, int height, const std::string& title, bool no
 bool Viewer::initWindow() {
     // Initialize GLFW
     if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to initialize GLFW!");
         return false;
     }
     
@@ -163,7 +172,7 @@ bool Viewer::initWindow() {
     m_window = glfwCreateWindow(m_windowWidth, m_windowHeight, 
                                 m_windowTitle.c_str(), nullptr, nullptr);
     if (!m_window) {
-        std::cerr << "Failed to create GLFW window!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to create GLFW window!");
         glfwTerminate();
         return false;
     }
@@ -183,13 +192,13 @@ bool Viewer::initWindow() {
 bool Viewer::initOpenGL() {
     // Initialize GLAD
     if (!gladLoadGL(glfwGetProcAddress)) {
-        std::cerr << "Failed to initialize GLAD!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Failed to initialize GLAD!");
         return false;
     }
     
-    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-    std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
-    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+    SMSTRIKERS_LOG_INFO("OpenGL Version: " << glGetString(GL_VERSION));
+    SMSTRIKERS_LOG_INFO("GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION));
+    SMSTRIKERS_LOG_INFO("Renderer: " << glGetString(GL_RENDERER));
     
     // Configure OpenGL
     glEnable(GL_DEPTH_TEST);
@@ -239,11 +248,11 @@ bool Viewer::initImGui() {
 
 int Viewer::run() {
     if (!m_initialized) {
-        std::cerr << "Error: Viewer not initialized!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("Error: Viewer not initialized!");
         return -1;
     }
     
-    std::cout << "Starting main loop..." << std::endl;
+    SMSTRIKERS_LOG_INFO("Starting main loop...");
     
     float lastFrame = 0.0f;
     
@@ -266,9 +275,12 @@ int Viewer::run() {
         // Swap buffers and poll events
         glfwSwapBuffers(m_window);
         glfwPollEvents();
+
+        // Messages queued by this frame's loads reach the terminal here
+        Log::flush();
     }
     
-    std::cout << "Main loop ended." << std::endl;
+    SMSTRIKERS_LOG_INFO("Main loop ended.");
     return 0;
 }
 
@@ -350,6 +362,56 @@ void Viewer::scrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 void Viewer::update(float deltaTime) {
     // Future: Update animations, etc.
     (void)deltaTime; // Unused for now
+    applyAssetTreeChanges();
+    pollBackgroundLoad();
+}
+
+void Viewer::pollBackgroundLoad() {
+    BackgroundLoader::Event event;
+    while (m_backgroundLoader.poll(event)) {
+        if (event.kind == BackgroundLoader::Event::Kind::Prefetched) {
+            if (event.generation == m_prefetchGeneration) {
+                storePrefetchedBundle(event.textureIndex, std::move(event.result));
+            }
+            continue;
+        }
+        if (event.generation != m_loadGeneration) {
+            continue; // Left over from a cancelled load
+        }
+        switch (event.kind) {
+        case BackgroundLoader::Event::Kind::Loaded:
+            m_lastLoadResult = std::move(*event.result);
+            m_lastLoaderName = m_pendingLoaderName;
+            m_lastLoadedPath = m_pendingLoadPath;
+            m_hasLoadResult = true;
+            if (m_lastLoadResult.success && m_lastLoadResult.textureBundle) {
+                buildLoadedTextures(m_lastLoadResult.textureBundle);
+            }
+            break;
+        case BackgroundLoader::Event::Kind::TextureDecoded: {
+            // Entries are in bundle order but skip empty images.
+            auto it = std::lower_bound(m_loadedTextures.begin(), m_loadedTextures.end(), event.textureIndex,
+                                       [](const LoadedTexture& texture, size_t index) {
+                                           return texture.imageIndex < index;
+                                       });
+            if (it != m_loadedTextures.end() && it->imageIndex == event.textureIndex) {
+                it->decoded = true;
+            }
+            break;
+        }
+        case BackgroundLoader::Event::Kind::Finished:
+            m_loadInProgress = false;
+            break;
+        case BackgroundLoader::Event::Kind::Prefetched:
+            break;
+        }
+    }
+}
+
+bool Viewer::isTextureReady(const LoadedTexture& texture) const {
+    // While the worker runs, only upload what it has decoded so the frame
+    // never waits on a decode.
+    return texture.decoded || texture.residentLevels > 0 || !m_loadInProgress;
 }
 
 void Viewer::render() {
@@ -357,6 +419,12 @@ void Viewer::render() {
     int displayW, displayH;
     glfwGetFramebufferSize(m_window, &displayW, &displayH);
     
+    // A non-positive budget uploads everything requested right away.
+    m_texturePool.beginFrame(static_cast<size_t>(std::max(0, m_config.texturePoolMB)) * 1024 * 1024);
+    m_textureUploader.beginFrame(m_config.textureUploadMBPerFrame > 0
+                                     ? static_cast<size_t>(m_config.textureUploadMBPerFrame) * 1024 * 1024
+                                     : SIZE_MAX);
+
     // Clear
     glViewport(0, 0, displayW, displayH);
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
@@ -385,7 +453,7 @@ void Viewer::renderUI() {
     ImVec2 workPos = viewport->WorkPos;
     ImVec2 workSize = viewport->WorkSize;
 
-    const AssetNode* selectedNode = m_assetTreeModel.findByPath(m_selectedAssetPath);
+    const AssetNode* selectedNode = m_assetTreeModel.node(m_selectedNode);
     bool showThumbnails = selectedNode && selectedNode->kind == AssetKind::TextureBundle;
 
     constexpr float leftRatio = 0.22f;
@@ -435,38 +503,18 @@ void Viewer::renderUI() {
 }
 
 void Viewer::setObjectToRender(const std::string& objectName) {
-    std::cout << "Setting object to render: " << objectName << std::endl;
+    SMSTRIKERS_LOG_INFO("Setting object to render: " << objectName);
     if (objectName.empty()) {
         return;
     }
 
-    const AssetNode* nodeByPath = m_assetTreeModel.findByPath(objectName);
-    if (nodeByPath) {
-        m_selectedAssetPath = nodeByPath->relativePath;
-        handleAssetSelection(nodeByPath);
-        return;
+    AssetNodeIndex index = m_assetTreeModel.findByPath(objectName);
+    if (index == kInvalidAssetNode) {
+        index = m_assetTreeModel.findByName(objectName);
     }
-
-    std::function<const AssetNode*(const std::vector<AssetNode>&)> findByName;
-    findByName = [&](const std::vector<AssetNode>& nodes) -> const AssetNode* {
-        for (const auto& node : nodes) {
-            if (node.name == objectName) {
-                return &node;
-            }
-            if (!node.children.empty()) {
-                const AssetNode* found = findByName(node.children);
-                if (found) {
-                    return found;
-                }
-            }
-        }
-        return nullptr;
-    };
-
-    const AssetNode* nodeByName = findByName(m_assetTreeModel.roots());
-    if (nodeByName) {
-        m_selectedAssetPath = nodeByName->relativePath;
-        handleAssetSelection(nodeByName);
+    if (index != kInvalidAssetNode) {
+        m_selectedNode = index;
+        handleAssetSelection(m_assetTreeModel.node(index));
     }
 }
 
@@ -561,20 +609,19 @@ void Viewer::renderAssetTreePanel(const ImVec2& pos, const ImVec2& size) {
     ImGui::Begin("Assets", nullptr, flags);
 
     ImGui::Text("Root: %s", m_config.assetsRoot.c_str());
-    if (!m_assetTreeModel.hasRoot() || m_assetTreeModel.roots().empty()) {
+    if (!m_assetTreeModel.hasRoot() || m_assetTreeModel.empty()) {
         ImGui::TextDisabled("No assets found");
     }
 
-    std::string previousSelection = m_selectedAssetPath;
+    AssetNodeIndex previousSelection = m_selectedNode;
     ImGui::BeginChild("AssetTreeView", ImVec2(0.0f, 0.0f), false);
-    if (!m_assetTreeModel.roots().empty()) {
-        m_assetTreeView.renderTree(m_assetTreeModel.roots(), m_selectedAssetPath);
+    if (!m_assetTreeModel.empty()) {
+        m_assetTreeView.renderTree(m_assetTreeModel, m_selectedNode);
     }
     ImGui::EndChild();
 
-    if (previousSelection != m_selectedAssetPath) {
-        const AssetNode* selectedNode = m_assetTreeModel.findByPath(m_selectedAssetPath);
-        handleAssetSelection(selectedNode);
+    if (previousSelection != m_selectedNode) {
+        handleAssetSelection(m_assetTreeModel.node(m_selectedNode));
     }
 
     ImGui::End();
@@ -586,11 +633,11 @@ void Viewer::renderPropertiesPanel(const ImVec2& pos, const ImVec2& size) {
     ImGuiWindowFlags flags = ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse;
     ImGui::Begin("Properties", nullptr, flags);
 
-    const AssetNode* selectedNode = m_assetTreeModel.findByPath(m_selectedAssetPath);
+    const AssetNode* selectedNode = m_assetTreeModel.node(m_selectedNode);
     if (selectedNode) {
-        ImGui::Text("Name: %s", selectedNode->name.c_str());
+        ImGui::Text("Name: %s", selectedNode->name.data());
         ImGui::Text("Type: %s", assetKindLabel(selectedNode->kind));
-        ImGui::Text("Path: %s", selectedNode->relativePath.c_str());
+        ImGui::Text("Path: %s", selectedNode->relativePath.data());
 
         ImGui::Separator();
         ImGui::Text("Loadable: %s", isLoadable(selectedNode->kind) ? "Yes" : "No");
@@ -600,6 +647,19 @@ void Viewer::renderPropertiesPanel(const ImVec2& pos, const ImVec2& size) {
             ImGui::Text("Package: Model Bundle (.glg)");
         }
 
+        if (m_loadInProgress && m_pendingLoadPath == selectedNode->relativePath) {
+            ImGui::Separator();
+            const size_t total = m_backgroundLoader.texturesTotal();
+            if (total > 0) {
+                const size_t done = m_backgroundLoader.texturesDecoded();
+                char overlay[64];
+                std::snprintf(overlay, sizeof(overlay), "%zu / %zu textures", done, total);
+                ImGui::ProgressBar(static_cast<float>(done) / static_cast<float>(total), ImVec2(-FLT_MIN, 0.0f), overlay);
+            } else {
+                ImGui::ProgressBar(0.0f, ImVec2(-FLT_MIN, 0.0f), "Loading...");
+            }
+        }
+
         if (m_hasLoadResult && m_lastLoadedPath == selectedNode->relativePath) {
             ImGui::Separator();
             ImGui::Text("Loader: %s", m_lastLoaderName.empty() ? "Unknown" : m_lastLoaderName.c_str());
@@ -620,20 +680,25 @@ void Viewer::renderPropertiesPanel(const ImVec2& pos, const ImVec2& size) {
                 ImGui::Text("Textures: %zu", m_loadedTextures.size());
                 ImVec2 listSize = ImVec2(-FLT_MIN, 180.0f);
                 if (ImGui::BeginListBox("##glt_textures", listSize)) {
-                    for (size_t i = 0; i < m_loadedTextures.size(); ++i) {
-                        const auto& tex = m_loadedTextures[i];
-                        bool isSelected = static_cast<int>(i) == m_selectedTextureIndex;
-                        char label[128];
-                        std::snprintf(label, sizeof(label), "0x%08X  %ux%u", tex.hash, tex.width, tex.height);
-                        if (ImGui::Selectable(label, isSelected)) {
-                            m_selectedTextureIndex = static_cast<int>(i);
-                            m_textureZoom = 1.0f;
-                            m_texturePan = ImVec2(0.0f, 0.0f);
-                        }
-                        if (isSelected) {
-                            ImGui::SetItemDefaultFocus();
+                    ImGuiListClipper clipper;
+                    clipper.Begin(static_cast<int>(m_loadedTextures.size()));
+                    while (clipper.Step()) {
+                        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                            const auto& tex = m_loadedTextures[i];
+                            bool isSelected = i == m_selectedTextureIndex;
+                            char label[128];
+                            std::snprintf(label, sizeof(label), "0x%08X  %ux%u", tex.hash, tex.width, tex.height);
+                            if (ImGui::Selectable(label, isSelected)) {
+                                m_selectedTextureIndex = i;
+                                m_textureZoom = 1.0f;
+                                m_texturePan = ImVec2(0.0f, 0.0f);
+                            }
+                            if (isSelected) {
+                                ImGui::SetItemDefaultFocus();
+                            }
                         }
                     }
+                    clipper.End();
                     ImGui::EndListBox();
                 }
 
@@ -674,63 +739,180 @@ void Viewer::renderThumbnailsPanel(const ImVec2& pos, const ImVec2& size) {
     if (columns < 1) {
         columns = 1;
     }
-    int columnIndex = 0;
-    for (size_t i = 0; i < m_loadedTextures.size(); ++i) {
-        const auto& tex = m_loadedTextures[i];
-        if (tex.textureId == 0) {
-            continue;
-        }
-        ImGui::PushID(static_cast<int>(i));
-        ImVec2 imageSize(m_thumbnailSize, m_thumbnailSize);
-        if (ImGui::ImageButton("##thumb", (void*)(intptr_t)tex.textureId, imageSize, ImVec2(0, 0), ImVec2(1, 1))) {
-            m_selectedTextureIndex = static_cast<int>(i);
-            m_textureZoom = 1.0f;
-            m_texturePan = ImVec2(0.0f, 0.0f);
-        }
-        if (ImGui::IsItemHovered()) {
-            ImGui::BeginTooltip();
-            ImGui::Text("0x%08X", tex.hash);
-            ImGui::Text("%ux%u", tex.width, tex.height);
-            ImGui::Text("%s", textureFormatLabel(tex.format));
-            ImGui::EndTooltip();
-        }
-        if (static_cast<int>(i) == m_selectedTextureIndex) {
-            ImDrawList* drawList = ImGui::GetWindowDrawList();
-            ImVec2 min = ImGui::GetItemRectMin();
-            ImVec2 max = ImGui::GetItemRectMax();
-            drawList->AddRect(min, max, IM_COL32(255, 200, 64, 255), 0.0f, 0, 2.0f);
-        }
-        ImGui::PopID();
-        columnIndex++;
-        if (columnIndex < columns) {
-            ImGui::SameLine();
-        } else {
-            columnIndex = 0;
+    const int count = static_cast<int>(m_loadedTextures.size());
+    const int rows = (count + columns - 1) / columns;
+    const ImVec2 framePadding = ImGui::GetStyle().FramePadding;
+    const float rowHeight = m_thumbnailSize + framePadding.y * 2.0f + ImGui::GetStyle().ItemSpacing.y;
+
+    // Only rows in view are submitted; GL textures are created for them alone.
+    int firstVisible = count;
+    int lastVisible = 0;
+    ImGuiListClipper clipper;
+    clipper.Begin(rows, rowHeight);
+    while (clipper.Step()) {
+        firstVisible = std::min(firstVisible, clipper.DisplayStart * columns);
+        lastVisible = std::max(lastVisible, std::min(count, clipper.DisplayEnd * columns));
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                const int i = row * columns + column;
+                if (i >= count) {
+                    break;
+                }
+                if (column > 0) {
+                    ImGui::SameLine();
+                }
+                auto& tex = m_loadedTextures[i];
+                ImGui::PushID(i);
+                ImVec2 imageSize(m_thumbnailSize, m_thumbnailSize);
+                if (isTextureReady(tex)) {
+                    ensureThumbnail(tex);
+                }
+                // Thumbnails share a few atlas pages, so ImGui batches most
+                // of the grid into one draw call per page.
+                ThumbnailAtlas::Slot slot;
+                if (tex.thumbnailSlot >= 0) {
+                    slot = m_thumbnailAtlas.slot(tex.thumbnailSlot);
+                }
+                if (ImGui::ImageButton("##thumb", (void*)(intptr_t)slot.texture, imageSize, ImVec2(slot.u0, slot.v0),
+                                       ImVec2(slot.u1, slot.v1))) {
+                    m_selectedTextureIndex = i;
+                    m_textureZoom = 1.0f;
+                    m_texturePan = ImVec2(0.0f, 0.0f);
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::BeginTooltip();
+                    ImGui::Text("0x%08X", tex.hash);
+                    ImGui::Text("%ux%u", tex.width, tex.height);
+                    ImGui::Text("%s", textureFormatLabel(tex.format));
+                    ImGui::EndTooltip();
+                }
+                if (i == m_selectedTextureIndex) {
+                    ImDrawList* drawList = ImGui::GetWindowDrawList();
+                    ImVec2 min = ImGui::GetItemRectMin();
+                    ImVec2 max = ImGui::GetItemRectMax();
+                    drawList->AddRect(min, max, IM_COL32(255, 200, 64, 255), 0.0f, 0, 2.0f);
+                }
+                ImGui::PopID();
+            }
         }
     }
+    clipper.End();
+
+    const int margin = kThumbnailResidentRows * columns;
+    releaseDistantThumbnails(std::max(0, firstVisible - margin), std::min(count, lastVisible + margin));
     ImGui::EndChild();
     ImGui::End();
 }
 
-void Viewer::refreshAssetTree() {
-    m_assetTreeModel.loadFromFilesystem(m_config.assetsRoot);
-
-    if (!m_selectedAssetPath.empty()) {
-        const AssetNode* node = m_assetTreeModel.findByPath(m_selectedAssetPath);
-        if (!node) {
-            m_selectedAssetPath.clear();
-        }
+void Viewer::refreshAssetTree(bool fullScan) {
+    // Node indices do not survive a rescan; carry the selection over by path.
+    const AssetNode* previous = m_assetTreeModel.node(m_selectedNode);
+    const std::string selectedPath = previous ? std::string(previous->relativePath) : std::string();
+    // The watcher follows the directories this scan found and lists again only
+    // those changed since, so nothing created during the scan is missed.
+    m_assetTreeWatcher.stop();
+    const bool watch = m_config.watchAssetsRoot && !m_config.assetsRoot.empty();
+    std::vector<ScannedDirectory> directories;
+    const bool loaded = m_assetTreeModel.loadFromFilesystem(m_config.assetsRoot, Config::getAssetIndexPath(),
+                                                            !fullScan, watch ? &directories : nullptr);
+    if (watch && loaded) {
+        m_assetTreeWatcher.start(m_config.assetsRoot, std::move(directories));
     }
+    m_selectedNode = m_assetTreeModel.findByPath(selectedPath);
 
-    if (m_selectedAssetPath.empty()) {
+    // Prefetched results could point at files under the old root.
+    m_backgroundLoader.cancelPrefetch();
+    m_prefetchTargets.clear();
+
+    if (m_selectedNode == kInvalidAssetNode) {
+        m_backgroundLoader.cancel();
+        m_loadInProgress = false;
         m_hasLoadResult = false;
         m_lastLoadedPath.clear();
         m_lastLoaderName.clear();
         clearLoadedTextures();
     }
+    // The root may have changed; cached bundles could point at other files.
+    clearBundleCache();
+}
+
+void Viewer::applyAssetTreeChanges() {
+    m_assetTreeChanges.clear();
+    m_assetTreeWatcher.takeChanges(m_assetTreeChanges);
+    if (m_assetTreeChanges.empty()) {
+        return;
+    }
+
+    const AssetNode* selected = m_assetTreeModel.node(m_selectedNode);
+    const std::string selectedPath = selected ? std::string(selected->relativePath) : std::string();
+    bool changed = false;
+    // Files whose contents changed under a name the tree already has
+    std::vector<const std::string*> rewritten;
+    auto markRewritten = [&](const std::string& path) {
+        if (std::none_of(rewritten.begin(), rewritten.end(), [&](const std::string* seen) { return *seen == path; })) {
+            rewritten.push_back(&path);
+        }
+    };
+    for (const AssetTreeChange& change : m_assetTreeChanges) {
+        switch (change.kind) {
+        case AssetTreeChange::Kind::Rescan:
+            refreshAssetTree();
+            return;
+        case AssetTreeChange::Kind::Added:
+            // Saving through a rename replaces the file under the same name.
+            if (m_assetTreeModel.findByPath(change.relativePath) != kInvalidAssetNode) {
+                markRewritten(change.relativePath);
+            } else {
+                changed |= m_assetTreeModel.addFile(change.relativePath);
+            }
+            break;
+        case AssetTreeChange::Kind::Modified:
+            markRewritten(change.relativePath);
+            break;
+        case AssetTreeChange::Kind::Removed:
+            changed |= m_assetTreeModel.remove(change.relativePath);
+            break;
+        }
+    }
+
+    if (changed) {
+        // Edits can move nodes to other indices.
+        m_selectedNode = m_assetTreeModel.findByPath(selectedPath);
+        if (!selectedPath.empty() && m_selectedNode == kInvalidAssetNode) {
+            handleAssetSelection(nullptr);
+        }
+        for (const AssetTreeChange& change : m_assetTreeChanges) {
+            if (change.kind == AssetTreeChange::Kind::Removed) {
+                dropCachedBundles(change.relativePath);
+            }
+        }
+    }
+
+    for (const std::string* path : rewritten) {
+        dropCachedBundles(*path);
+        // A prefetch of the old contents would put them back in the cache.
+        if (std::any_of(m_prefetchTargets.begin(), m_prefetchTargets.end(), [&](const PrefetchTarget& target) {
+                return target.path == *path;
+            })) {
+            m_backgroundLoader.cancelPrefetch();
+            m_prefetchTargets.clear();
+        }
+        if (*path == selectedPath && m_selectedNode != kInvalidAssetNode) {
+            // Drop what is shown rather than stash it, then load the file again.
+            clearLoadedTextures();
+            handleAssetSelection(m_assetTreeModel.node(m_selectedNode));
+        }
+    }
 }
 
 void Viewer::handleAssetSelection(const AssetNode* node) {
+    // Whatever was loading belongs to the previous selection.
+    m_backgroundLoader.cancel();
+    m_backgroundLoader.cancelPrefetch();
+    m_prefetchTargets.clear();
+    m_loadInProgress = false;
+    m_pendingLoadPath.clear();
+    stashLoadedTextures();
     m_hasLoadResult = false;
     m_lastLoadedPath.clear();
     m_lastLoaderName.clear();
@@ -749,6 +931,15 @@ void Viewer::handleAssetSelection(const AssetNode* node) {
         return;
     }
 
+    if (node->kind == AssetKind::TextureBundle && restoreCachedBundle(node->relativePath)) {
+        // Finish decoding whatever was not reached before it was stashed.
+        m_loadGeneration = m_backgroundLoader.decode(m_loadedBundle);
+        m_pendingLoadPath = node->relativePath;
+        m_loadInProgress = true;
+        schedulePrefetch(node);
+        return;
+    }
+
     std::filesystem::path fullPath = std::filesystem::path(m_assetTreeModel.rootPath()) / node->relativePath;
     const IAssetLoader* loader = m_assetLoaders.getLoaderForExtension(fullPath.extension().string());
     if (!loader) {
@@ -758,14 +949,108 @@ void Viewer::handleAssetSelection(const AssetNode* node) {
         return;
     }
 
-    m_lastLoadResult = loader->load(fullPath);
-    m_lastLoaderName = loader->name();
-    m_lastLoadedPath = node->relativePath;
-    m_hasLoadResult = true;
+    // The worker indexes the file, then decodes textures one by one;
+    // pollBackgroundLoad() picks up the results as they arrive.
+    AssetLoadOptions loadOptions;
+    loadOptions.decodeTextures = false;
+    loadOptions.textureCache = m_textureCache;
+    m_loadGeneration = m_backgroundLoader.load(loader, fullPath, loadOptions);
+    m_pendingLoadPath = node->relativePath;
+    m_pendingLoaderName = loader->name();
+    m_loadInProgress = true;
+    schedulePrefetch(node);
+}
 
-    if (node->kind == AssetKind::TextureBundle && m_lastLoadResult.success && m_lastLoadResult.textureBundle) {
-        buildLoadedTextures(*m_lastLoadResult.textureBundle);
+void Viewer::schedulePrefetch(const AssetNode* node) {
+    if (!m_config.prefetchNeighbors) {
+        return;
+    }
+
+    const AssetNode* parent = m_assetTreeModel.node(node->parent);
+    if (!parent) {
+        return;
+    }
+    const AssetNodeIndex first = parent->firstChild;
+    const AssetNodeIndex end = parent->firstChild + parent->childCount;
+    const AssetNodeIndex self = m_assetTreeModel.indexOf(*node);
+
+    // Next first: audits mostly step forward through the tree.
+    std::vector<const AssetNode*> candidates;
+    for (AssetNodeIndex index = self + 1; index < end; ++index) {
+        const AssetNode* sibling = m_assetTreeModel.node(index);
+        if (isLoadable(sibling->kind)) {
+            candidates.push_back(sibling);
+            break;
+        }
     }
+    for (AssetNodeIndex index = self; index > first;) {
+        const AssetNode* sibling = m_assetTreeModel.node(--index);
+        if (isLoadable(sibling->kind)) {
+            candidates.push_back(sibling);
+            break;
+        }
+    }
+
+    // Bundles already in memory need no warming.
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const AssetNode* candidate) {
+        return std::any_of(m_bundleCache.begin(), m_bundleCache.end(), [&](const CachedBundle& entry) {
+            return entry.path == candidate->relativePath;
+        });
+    }), candidates.end());
+    if (candidates.empty()) {
+        return;
+    }
+
+    // Decode fully only into what the bundle cache has left.
+    size_t freeBytes = static_cast<size_t>(std::max(0, m_config.bundleCacheCpuMB)) * 1024 * 1024;
+    for (const auto& entry : m_bundleCache) {
+        freeBytes -= std::min(freeBytes, entry.cpuBytes);
+    }
+
+    std::vector<BackgroundLoader::PrefetchRequest> requests;
+    for (const AssetNode* candidate : candidates) {
+        std::filesystem::path fullPath = std::filesystem::path(m_assetTreeModel.rootPath()) / candidate->relativePath;
+        const IAssetLoader* loader = m_assetLoaders.getLoaderForExtension(fullPath.extension().string());
+        if (!loader) {
+            continue;
+        }
+        BackgroundLoader::PrefetchRequest request;
+        request.loader = loader;
+        request.path = fullPath;
+        request.options.decodeTextures = false;
+        request.options.textureCache = m_textureCache;
+        request.decodeBudgetBytes = freeBytes / candidates.size();
+        requests.push_back(std::move(request));
+        m_prefetchTargets.push_back({std::string(candidate->relativePath), loader->name()});
+    }
+    if (!requests.empty()) {
+        m_prefetchGeneration = m_backgroundLoader.prefetch(std::move(requests));
+    }
+}
+
+void Viewer::storePrefetchedBundle(size_t targetIndex, std::shared_ptr<AssetLoadResult> result) {
+    if (targetIndex >= m_prefetchTargets.size() || !result || !result->success || !result->textureBundle ||
+        m_config.bundleCacheCpuMB <= 0 || m_config.bundleCacheGpuMB <= 0) {
+        return;
+    }
+    const PrefetchTarget& target = m_prefetchTargets[targetIndex];
+    if (target.path == m_loadedTexturePath || target.path == m_pendingLoadPath ||
+        std::any_of(m_bundleCache.begin(), m_bundleCache.end(), [&](const CachedBundle& entry) {
+            return entry.path == target.path;
+        })) {
+        return;
+    }
+
+    // Texture entries and GL textures are created when it is selected.
+    CachedBundle entry;
+    entry.path = target.path;
+    entry.loaderName = target.loaderName;
+    for (const auto& image : result->textureBundle->textures) {
+        entry.cpuBytes += image.heapBytes();
+    }
+    entry.result = std::move(*result);
+    m_bundleCache.push_front(std::move(entry));
+    trimBundleCache();
 }
 
 void Viewer::renderViewportPanel(const ImVec2& pos, const ImVec2& size) {
@@ -784,13 +1069,13 @@ void Viewer::renderViewportPanel(const ImVec2& pos, const ImVec2& size) {
     ImVec2 viewportSize = ImGui::GetContentRegionAvail();
     
     if (viewportSize.x > 0 && viewportSize.y > 0) {
-        const AssetNode* selectedNode = m_assetTreeModel.findByPath(m_selectedAssetPath);
+        const AssetNode* selectedNode = m_assetTreeModel.node(m_selectedNode);
         bool isTexturePreview = selectedNode && selectedNode->kind == AssetKind::TextureBundle &&
                                 !m_loadedTextures.empty() && m_lastLoadedPath == selectedNode->relativePath;
         bool canRender = selectedNode && isLoadable(selectedNode->kind) && !isTexturePreview;
 
         if (isTexturePreview) {
-            const auto& texture = m_loadedTextures[std::clamp(m_selectedTextureIndex, 0, static_cast<int>(m_loadedTextures.size() - 1))];
+            auto& texture = m_loadedTextures[std::clamp(m_selectedTextureIndex, 0, static_cast<int>(m_loadedTextures.size() - 1))];
             if (m_isViewportHovered) {
                 float wheel = ImGui::GetIO().MouseWheel;
                 if (wheel != 0.0f) {
@@ -813,10 +1098,28 @@ void Viewer::renderViewportPanel(const ImVec2& pos, const ImVec2& size) {
             float baseScale = std::min(1.0f, std::min(scaleX, scaleY));
             float scale = baseScale * m_textureZoom;
             ImVec2 imageSize(texture.width * scale, texture.height * scale);
+
+            // Sample from the mip level closest to the on-screen size; levels
+            // are only decoded and uploaded once the zoom needs them.
+            uint32_t previewLevel = 0;
+            for (float levelScale = scale; levelScale <= 0.5f; levelScale *= 2.0f) {
+                previewLevel++;
+            }
+            if (isTextureReady(texture)) {
+                ensureTextureLevels(texture, previewLevel);
+            }
+
             ImVec2 imagePos((viewportSize.x - imageSize.x) * 0.5f + m_texturePan.x,
                             (viewportSize.y - imageSize.y) * 0.5f + m_texturePan.y);
-            ImGui::SetCursorPos(imagePos);
-            ImGui::Image((void*)(intptr_t)texture.textureId, imageSize, ImVec2(0, 0), ImVec2(1, 1));
+            if (texture.residentLevels > 0 && texture.textureId != 0) {
+                ImGui::SetCursorPos(imagePos);
+                ImGui::Image((void*)(intptr_t)texture.textureId, imageSize, ImVec2(0, 0), ImVec2(1, 1));
+            } else if (texture.thumbnailSlot >= 0) {
+                // Stand in with the thumbnail while level 0 streams in.
+                const ThumbnailAtlas::Slot& slot = m_thumbnailAtlas.slot(texture.thumbnailSlot);
+                ImGui::SetCursorPos(imagePos);
+                ImGui::Image((void*)(intptr_t)slot.texture, imageSize, ImVec2(slot.u0, slot.v0), ImVec2(slot.u1, slot.v1));
+            }
 
         } else if (canRender) {
             // Recreate framebuffer if size changed
@@ -891,11 +1194,20 @@ void Viewer::renderViewportPanel(const ImVec2& pos, const ImVec2& size) {
 }
 
 void Viewer::shutdown() {
-    std::cout << "Shutting down viewer..." << std::endl;
+    SMSTRIKERS_LOG_INFO("Shutting down viewer...");
     
+    m_assetTreeWatcher.stop();
+    m_backgroundLoader.cancel();
+    m_backgroundLoader.cancelPrefetch();
+    m_loadInProgress = false;
+
     // Cleanup framebuffer
     deleteFramebuffer();
     clearLoadedTextures();
+    clearBundleCache();
+    m_thumbnailAtlas.clear();
+    m_textureUploader.clear();
+    m_texturePool.clear();
     
     // Cleanup ImGui only if it was initialized
     if (!m_noGui) {
@@ -943,7 +1255,7 @@ void Viewer::createFramebuffer(int width, int height) {
     
     // Check framebuffer completeness
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "ERROR: Framebuffer is not complete!" << std::endl;
+        SMSTRIKERS_LOG_ERROR("ERROR: Framebuffer is not complete!");
     }
     
     // Unbind framebuffer
@@ -965,60 +1277,257 @@ void Viewer::deleteFramebuffer() {
     }
 }
 
+void Viewer::releaseTexture(LoadedTexture& texture) {
+    // Back to the pool; it is deleted or reused a few frames from now.
+    TexturePool::Texture pooled;
+    pooled.id = texture.textureId;
+    pooled.width = texture.width;
+    pooled.height = texture.height;
+    pooled.internalFormat = GL_RGBA8;
+    pooled.allocatedLevels = texture.allocatedLevels;
+    m_texturePool.release(pooled);
+    m_thumbnailAtlas.remove(texture.thumbnailSlot);
+    texture.textureId = 0;
+    texture.thumbnailSlot = -1;
+    texture.allocatedLevels = 0;
+    texture.residentLevels = 0;
+    texture.uploadedRows = 0;
+    texture.gpuBytes = 0;
+}
+
+void Viewer::ensureThumbnail(LoadedTexture& texture) {
+    if (texture.thumbnailSlot >= 0 || !m_textureUploader.hasBudget() || !m_loadedBundle ||
+        texture.imageIndex >= m_loadedBundle->textures.size()) {
+        return;
+    }
+    const TextureImage& image = m_loadedBundle->textures[texture.imageIndex];
+    PixelView pixels = image.thumbnailPixels();
+    if (pixels.empty()) {
+        return;
+    }
+    texture.thumbnailSlot = m_thumbnailAtlas.add(pixels.data(), image.thumbnailWidth(), image.thumbnailHeight());
+    if (texture.thumbnailSlot >= 0) {
+        m_textureUploader.charge(pixels.size());
+    }
+}
+
+void Viewer::releaseDistantThumbnails(int keepBegin, int keepEnd) {
+    // Only rescan the list when the kept window moves or the selection
+    // changes, which can leave the previous selection far out of view.
+    if (keepBegin == m_residentThumbnailsBegin && keepEnd == m_residentThumbnailsEnd &&
+        m_selectedTextureIndex == m_residentSelectedIndex) {
+        return;
+    }
+    m_residentThumbnailsBegin = keepBegin;
+    m_residentThumbnailsEnd = keepEnd;
+    m_residentSelectedIndex = m_selectedTextureIndex;
+    for (int i = 0; i < static_cast<int>(m_loadedTextures.size()); ++i) {
+        // The viewport shows the selected texture whatever the grid scroll.
+        if ((i < keepBegin || i >= keepEnd) && i != m_selectedTextureIndex) {
+            releaseTexture(m_loadedTextures[i]);
+        }
+    }
+}
+
 void Viewer::clearLoadedTextures() {
     for (auto& texture : m_loadedTextures) {
-        if (texture.textureId != 0) {
-            glDeleteTextures(1, &texture.textureId);
-        }
+        releaseTexture(texture);
     }
     m_loadedTextures.clear();
+    m_residentThumbnailsBegin = -1;
+    m_residentThumbnailsEnd = -1;
+    m_residentSelectedIndex = -1;
+    m_loadedBundle.reset();
     m_selectedTextureIndex = 0;
     m_loadedTexturePath.clear();
     m_textureZoom = 1.0f;
     m_texturePan = ImVec2(0.0f, 0.0f);
 }
 
-void Viewer::buildLoadedTextures(const TextureBundle& bundle) {
+void Viewer::buildLoadedTextures(const std::shared_ptr<TextureBundle>& bundle) {
     clearLoadedTextures();
-    if (bundle.textures.empty()) {
+    if (!bundle || bundle->textures.empty()) {
         return;
     }
 
-    m_loadedTextures.reserve(bundle.textures.size());
-    GLint previousAlignment = 4;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    for (const auto& image : bundle.textures) {
-        if (image.rgba.empty() || image.width == 0 || image.height == 0) {
+    // Entries only carry header data; GL textures are created by
+    // ensureTextureLevels() when a panel first draws them.
+    m_loadedBundle = bundle;
+    m_loadedTextures.reserve(bundle->textures.size());
+    for (size_t imageIndex = 0; imageIndex < bundle->textures.size(); ++imageIndex) {
+        const TextureImage& image = bundle->textures[imageIndex];
+        if (image.width == 0 || image.height == 0) {
             continue;
         }
-        GLuint textureId = 0;
-        glGenTextures(1, &textureId);
-        glBindTexture(GL_TEXTURE_2D, textureId);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.rgba.data());
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
         LoadedTexture entry;
         entry.hash = image.hash;
         entry.width = image.width;
         entry.height = image.height;
         entry.format = image.format;
-        entry.textureId = textureId;
+        entry.imageIndex = imageIndex;
         m_loadedTextures.push_back(entry);
     }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
     m_loadedTexturePath = m_lastLoadedPath;
     m_selectedTextureIndex = 0;
     m_textureZoom = 1.0f;
     m_texturePan = ImVec2(0.0f, 0.0f);
 }
 
+void Viewer::ensureTextureLevels(LoadedTexture& texture, uint32_t maxLevel) {
+    if (!m_loadedBundle || texture.imageIndex >= m_loadedBundle->textures.size()) {
+        return;
+    }
+    const TextureImage& image = m_loadedBundle->textures[texture.imageIndex];
+    uint32_t wantedLevels = std::min(maxLevel + 1, image.levelCount());
+
+    // Levels stream in over as many frames as the upload budget needs, and
+    // must stay contiguous from 0 for the texture to be mip-complete.
+    while (texture.residentLevels < wantedLevels && m_textureUploader.hasBudget()) {
+        const uint32_t level = texture.residentLevels;
+        PixelView pixels = image.levelPixels(level);
+        if (pixels.empty()) {
+            // A level that fails to decode ends the chain; do not retry it every frame.
+            texture.residentLevels = image.levelCount();
+            break;
+        }
+        const int width = image.levelWidth(level);
+        const int height = image.levelHeight(level);
+        if (texture.textureId == 0) {
+            // A recycled texture keeps its level storage but not our parameters.
+            TexturePool::Texture pooled = m_texturePool.acquire(image.width, image.height, GL_RGBA8);
+            texture.textureId = pooled.id;
+            texture.allocatedLevels = pooled.allocatedLevels;
+            glBindTexture(GL_TEXTURE_2D, texture.textureId);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        if (level >= texture.allocatedLevels) {
+            glBindTexture(GL_TEXTURE_2D, texture.textureId);
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA8, width, height, 0, GL_RGBA,
+                         GL_UNSIGNED_BYTE, nullptr);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            texture.allocatedLevels = level + 1;
+        }
+        texture.uploadedRows += m_textureUploader.uploadRows(texture.textureId, static_cast<GLint>(level), width,
+                                                             height, texture.uploadedRows, pixels.data());
+        if (texture.uploadedRows < height) {
+            break;
+        }
+
+        texture.uploadedRows = 0;
+        texture.residentLevels = level + 1;
+        texture.gpuBytes += static_cast<size_t>(width) * height * 4;
+        glBindTexture(GL_TEXTURE_2D, texture.textureId);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(level));
+        if (level > 0) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void Viewer::stashLoadedTextures() {
+    if (!m_loadedBundle || m_loadedTexturePath.empty() || m_config.bundleCacheCpuMB <= 0 ||
+        m_config.bundleCacheGpuMB <= 0) {
+        return;
+    }
+
+    CachedBundle entry;
+    entry.path = m_loadedTexturePath;
+    entry.loaderName = m_lastLoaderName;
+    entry.result = m_lastLoadResult;
+    entry.selectedTextureIndex = m_selectedTextureIndex;
+    for (const auto& image : m_loadedBundle->textures) {
+        entry.cpuBytes += image.heapBytes();
+    }
+    for (const auto& texture : m_loadedTextures) {
+        entry.gpuBytes += texture.gpuBytes;
+    }
+    entry.textures = std::move(m_loadedTextures);
+    m_loadedTextures.clear();
+    m_bundleCache.push_front(std::move(entry));
+    trimBundleCache();
+}
+
+bool Viewer::restoreCachedBundle(std::string_view path) {
+    auto it = std::find_if(m_bundleCache.begin(), m_bundleCache.end(), [&](const CachedBundle& entry) {
+        return entry.path == path;
+    });
+    if (it == m_bundleCache.end()) {
+        return false;
+    }
+
+    clearLoadedTextures();
+    m_lastLoadResult = std::move(it->result);
+    m_lastLoaderName = std::move(it->loaderName);
+    m_lastLoadedPath = path;
+    m_hasLoadResult = true;
+    m_loadedBundle = m_lastLoadResult.textureBundle;
+    m_loadedTextures = std::move(it->textures);
+    m_loadedTexturePath = path;
+    m_selectedTextureIndex = it->selectedTextureIndex;
+    m_bundleCache.erase(it);
+    if (m_loadedTextures.empty()) {
+        // Prefetched bundles arrive without texture entries.
+        buildLoadedTextures(m_lastLoadResult.textureBundle);
+    }
+    return true;
+}
+
+void Viewer::trimBundleCache() {
+    const size_t cpuBudget = static_cast<size_t>(std::max(0, m_config.bundleCacheCpuMB)) * 1024 * 1024;
+    const size_t gpuBudget = static_cast<size_t>(std::max(0, m_config.bundleCacheGpuMB)) * 1024 * 1024;
+    size_t cpuBytes = 0;
+    size_t gpuBytes = 0;
+    for (const auto& entry : m_bundleCache) {
+        cpuBytes += entry.cpuBytes;
+        gpuBytes += entry.gpuBytes;
+    }
+
+    // Thumbnails are charged by whole atlas pages, which only shrink once an
+    // eviction frees a page's last cell.
+    while (!m_bundleCache.empty() &&
+           (cpuBytes > cpuBudget || gpuBytes + m_thumbnailAtlas.gpuBytes() > gpuBudget)) {
+        CachedBundle& victim = m_bundleCache.back();
+        for (auto& texture : victim.textures) {
+            releaseTexture(texture);
+        }
+        cpuBytes -= victim.cpuBytes;
+        gpuBytes -= victim.gpuBytes;
+        m_bundleCache.pop_back();
+    }
+}
+
+void Viewer::dropCachedBundles(std::string_view relativePath) {
+    for (auto it = m_bundleCache.begin(); it != m_bundleCache.end();) {
+        const std::string& path = it->path;
+        bool below = path.size() > relativePath.size() && path[relativePath.size()] == '/' &&
+                     path.compare(0, relativePath.size(), relativePath) == 0;
+        if (path != relativePath && !below) {
+            ++it;
+            continue;
+        }
+        for (auto& texture : it->textures) {
+            releaseTexture(texture);
+        }
+        it = m_bundleCache.erase(it);
+    }
+}
+
+void Viewer::clearBundleCache() {
+    for (auto& entry : m_bundleCache) {
+        for (auto& texture : entry.textures) {
+            releaseTexture(texture);
+        }
+    }
+    m_bundleCache.clear();
+}
+
 void Viewer::renderConfigDialog() {
     ImGui::SetNextWindowSize(ImVec2(500, 400), ImGuiCond_FirstUseEver);
     if (ImGui::Begin("Settings", &m_showConfigDialog)) {
@@ -1083,6 +1592,10 @@ void Viewer::renderConfigDialog() {
         }
         ImGui::SameLine();
         if (ImGui::Button("Rescan")) {
+            refreshAssetTree(true);
+        }
+        if (ImGui::Checkbox("Watch for changes", &m_config.watchAssetsRoot)) {
+            configChanged = true;
             refreshAssetTree();
         }
         const AssetTreeStats& stats = m_assetTreeModel.stats();